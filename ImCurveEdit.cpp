@@ -1,14 +1,12 @@
 #include "ImCurveEdit.h"
+#include "ImGuizmoProfiler.h"
+#include "ImGuizmoState.h"
 #include "imgui.h"
 #include "imgui_internal.h"
 #include <stdint.h>
-#include <set>
+#include <string.h>
 #include <vector>
 
-#if !defined(_MSC_VER)
-#define _malloca(x) alloca(x)
-#endif
-
 namespace ImCurveEdit
 {
 
@@ -34,12 +32,6 @@ namespace ImCurveEdit
    }
 #endif
 
-   static float smoothstep(float edge0, float edge1, float x)
-   {
-      x = ImClamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
-      return x * x * (3 - 2 * x);
-   }
-
    static float distance(float x, float y, float x1, float y1, float x2, float y2)
    {
       float A = x - x1;
@@ -73,7 +65,347 @@ namespace ImCurveEdit
       return sqrtf(dx * dx + dy * dy);
    }
 
-   static int DrawPoint(ImDrawList* draw_list, ImVec2 pos, const ImVec2 size, const ImVec2 offset, bool edited)
+   // curve evaluation
+   static ImVec2 HermiteTangent(const ImVec2* pts, size_t ptCount, size_t p)
+   {
+      // Catmull-Rom slope, one sided at both ends
+      const size_t p1 = (p > 0) ? p - 1 : p;
+      const size_t p2 = (p < ptCount - 1) ? p + 1 : p;
+      const float dx = pts[p2].x - pts[p1].x;
+      const float slope = (dx > FLT_EPSILON) ? (pts[p2].y - pts[p1].y) / dx : 0.f;
+      return ImVec2(1.f, slope);
+   }
+
+   void GetSegmentControlPoints(CurveType curveType, const ImVec2* pts, const ImVec2* tangents, size_t ptCount, size_t p, ImVec2* cp)
+   {
+      const ImVec2 p1 = pts[p];
+      const ImVec2 p2 = pts[p + 1];
+      const float third = (p2.x - p1.x) / 3.f;
+      cp[0] = p1;
+      cp[3] = p2;
+      switch (curveType)
+      {
+      case CurveSmooth:
+         cp[1] = ImVec2(p1.x + third, p1.y);
+         cp[2] = ImVec2(p2.x - third, p2.y);
+         break;
+      case CurveBezier:
+         if (tangents)
+         {
+            // keep x monotonic in the segment so the curve stays a function of x
+            ImVec2 h1 = tangents[p * 2 + 1];
+            ImVec2 h2 = tangents[(p + 1) * 2];
+            h1.x = ImMax(h1.x, 0.f);
+            h2.x = ImMin(h2.x, 0.f);
+            const float handleLength = h1.x - h2.x;
+            if (handleLength > third * 3.f && handleLength > FLT_EPSILON)
+            {
+               const float scale = third * 3.f / handleLength;
+               h1 = h1 * scale;
+               h2 = h2 * scale;
+            }
+            cp[1] = p1 + h1;
+            cp[2] = p2 + h2;
+         }
+         else
+         {
+            cp[1] = p1 + HermiteTangent(pts, ptCount, p) * third;
+            cp[2] = p2 - HermiteTangent(pts, ptCount, p + 1) * third;
+         }
+         break;
+      case CurveDiscrete:
+         cp[1] = cp[2] = ImVec2(p2.x, p1.y);
+         break;
+      default:
+         cp[1] = ImLerp(p1, p2, 1.f / 3.f);
+         cp[2] = ImLerp(p1, p2, 2.f / 3.f);
+         break;
+      }
+   }
+
+   static float BezierValue(float a, float b, float c, float d, float t)
+   {
+      const float it = 1.f - t;
+      return it * it * it * a + 3.f * it * it * t * b + 3.f * it * t * t * c + t * t * t * d;
+   }
+
+   static float BezierDerivative(float a, float b, float c, float d, float t)
+   {
+      const float it = 1.f - t;
+      return 3.f * (it * it * (b - a) + 2.f * it * t * (c - b) + t * t * (d - c));
+   }
+
+   // parameter t of the segment where x(t) == x. Newton steps guarded by bisection
+   static float SolveBezierX(const ImVec2* cp, float x)
+   {
+      const float dx = cp[3].x - cp[0].x;
+      if (dx <= FLT_EPSILON)
+         return 1.f;
+      float t = ImClamp((x - cp[0].x) / dx, 0.f, 1.f);
+      float lo = 0.f;
+      float hi = 1.f;
+      for (int i = 0; i < 16; i++)
+      {
+         const float err = BezierValue(cp[0].x, cp[1].x, cp[2].x, cp[3].x, t) - x;
+         if (fabsf(err) < dx * 1e-6f)
+            break;
+         if (err < 0.f)
+            lo = t;
+         else
+            hi = t;
+         const float d = BezierDerivative(cp[0].x, cp[1].x, cp[2].x, cp[3].x, t);
+         t = (fabsf(d) > FLT_EPSILON) ? t - err / d : (lo + hi) * 0.5f;
+         if (t <= lo || t >= hi)
+            t = (lo + hi) * 0.5f;
+      }
+      return t;
+   }
+
+   // flatten a screen space cubic Bezier, appending every point but the first one
+   static void TessellateBezier(ImVector<ImVec2>& polyline, const ImVec2& p1, const ImVec2& p2, const ImVec2& p3, const ImVec2& p4, int level)
+   {
+      static const float flatnessTolerance = 0.5f; // in pixels
+      const float dx = p4.x - p1.x;
+      const float dy = p4.y - p1.y;
+      const float d2 = fabsf((p2.x - p4.x) * dy - (p2.y - p4.y) * dx);
+      const float d3 = fabsf((p3.x - p4.x) * dy - (p3.y - p4.y) * dx);
+      if ((d2 + d3) * (d2 + d3) <= flatnessTolerance * flatnessTolerance * (dx * dx + dy * dy) || level >= 10)
+      {
+         polyline.push_back(p4);
+         return;
+      }
+      const ImVec2 p12 = (p1 + p2) * 0.5f;
+      const ImVec2 p23 = (p2 + p3) * 0.5f;
+      const ImVec2 p34 = (p3 + p4) * 0.5f;
+      const ImVec2 p123 = (p12 + p23) * 0.5f;
+      const ImVec2 p234 = (p23 + p34) * 0.5f;
+      const ImVec2 p1234 = (p123 + p234) * 0.5f;
+      TessellateBezier(polyline, p1, p12, p123, p1234, level + 1);
+      TessellateBezier(polyline, p1234, p234, p34, p4, level + 1);
+   }
+
+   // index of the first point strictly after x. Points are sorted on x
+   static size_t FindPointAfter(const ImVec2* pts, size_t ptCount, float x)
+   {
+      size_t first = 0;
+      size_t count = ptCount;
+      while (count > 0)
+      {
+         const size_t step = count / 2;
+         if (pts[first + step].x <= x)
+         {
+            first += step + 1;
+            count -= step + 1;
+         }
+         else
+         {
+            count = step;
+         }
+      }
+      return first;
+   }
+
+   void GetSegmentControlPoints(Delegate &delegate, size_t curveIndex, size_t pointIndex, ImVec2 *controlPoints)
+   {
+      const CurveType curveType = delegate.GetCurveType(curveIndex);
+      GetSegmentControlPoints(curveType, delegate.GetPoints(curveIndex), (curveType == CurveBezier) ? delegate.GetTangents(curveIndex) : NULL, delegate.GetPointCount(curveIndex), pointIndex, controlPoints);
+   }
+
+   float EvaluateSegment(CurveType curveType, const ImVec2 *cp, float x)
+   {
+      switch (curveType)
+      {
+      case CurveDiscrete:
+         return (x < cp[3].x) ? cp[0].y : cp[3].y;
+      case CurveLinear:
+      {
+         const float dx = cp[3].x - cp[0].x;
+         return (dx > FLT_EPSILON) ? ImLerp(cp[0].y, cp[3].y, ImClamp((x - cp[0].x) / dx, 0.f, 1.f)) : cp[3].y;
+      }
+      default:
+      {
+         const float t = SolveBezierX(cp, x);
+         return BezierValue(cp[0].y, cp[1].y, cp[2].y, cp[3].y, t);
+      }
+      }
+   }
+
+   float Evaluate(Delegate &delegate, size_t curveIndex, float x)
+   {
+      const size_t ptCount = delegate.GetPointCount(curveIndex);
+      if (!ptCount)
+         return 0.f;
+      const ImVec2* pts = delegate.GetPoints(curveIndex);
+      if (x <= pts[0].x)
+         return pts[0].y;
+      if (x >= pts[ptCount - 1].x)
+         return pts[ptCount - 1].y;
+
+      const size_t first = FindPointAfter(pts, ptCount, x);
+      const CurveType curveType = delegate.GetCurveType(curveIndex);
+      ImVec2 cp[4];
+      GetSegmentControlPoints(curveType, pts, (curveType == CurveBezier) ? delegate.GetTangents(curveIndex) : NULL, ptCount, first - 1, cp);
+      return EvaluateSegment(curveType, cp, x);
+   }
+
+   static const float curveThickness = 1.3f;
+
+   // what the geometry of a curve depends on, besides the view
+   struct CurveKey
+   {
+      const Delegate* delegate = NULL;
+      size_t curveIndex = 0;
+      // the points buffer tells apart curves taking over the index of a removed or moved one
+      const ImVec2* points = NULL;
+      size_t pointCount = 0;
+      unsigned int version = 0; // 0 when not cached
+      CurveType curveType = CurveNone;
+      uint32_t color = 0;
+      float thickness = 0.f;
+      ImDrawListFlags drawListFlags = 0; // anti-aliasing
+
+      bool operator ==(const CurveKey& other) const
+      {
+         return delegate == other.delegate && curveIndex == other.curveIndex && points == other.points && pointCount == other.pointCount &&
+            version == other.version && curveType == other.curveType && color == other.color && thickness == other.thickness && drawListFlags == other.drawListFlags;
+      }
+   };
+
+   // projected polyline and draw list geometry of a curve, reused while its key and the view don't change
+   struct CurveCache
+   {
+      CurveKey key;
+      ImVec2 viewMin, viewRange, viewSize, viewOffset;
+      ImVector<ImVec2> polyline;
+      ImRect bounds;
+      ImRetainedGeometry geometry;
+
+      bool IsSameView(const ImVec2& min, const ImVec2& range, const ImVec2& size, const ImVec2& offset) const
+      {
+         return viewMin.x == min.x && viewMin.y == min.y && viewRange.x == range.x && viewRange.y == range.y &&
+            viewSize.x == size.x && viewSize.y == size.y && viewOffset.x == offset.x && viewOffset.y == offset.y;
+      }
+
+      void SetView(const ImVec2& min, const ImVec2& range, const ImVec2& size, const ImVec2& offset)
+      {
+         viewMin = min;
+         viewRange = range;
+         viewSize = size;
+         viewOffset = offset;
+      }
+
+      // draw the polyline and keep a copy of the generated vertices
+      void Capture(ImDrawList* draw_list, uint32_t curveColor)
+      {
+         geometry.Begin(draw_list);
+         if (polyline.Size > 1)
+            draw_list->AddPolyline(polyline.Data, polyline.Size, curveColor, false, curveThickness);
+         geometry.End(draw_list);
+      }
+
+      void Emit(ImDrawList* draw_list) const
+      {
+         if (geometry.vertices.empty())
+         {
+            if (polyline.Size > 1)
+               draw_list->AddPolyline(polyline.Data, polyline.Size, key.color, false, curveThickness);
+            return;
+         }
+         geometry.Emit(draw_list);
+      }
+   };
+
+   // transient storage of an editor, grown once and reused across frames
+   struct Scratch
+   {
+      ImVector<int> curvesIndex;
+      ImVector<ImVec2> originalPoints;
+      ImVector<EditPoint> movedSelection;
+      std::vector<CurveCache> curveCaches;
+
+      // buffers never shrink so their capacity is the peak usage
+      size_t GetPeakUsage() const
+      {
+         size_t usage = curvesIndex.capacity() * sizeof(int) + originalPoints.capacity() * sizeof(ImVec2) + movedSelection.capacity() * sizeof(EditPoint);
+         for (const CurveCache& cache : curveCaches)
+            usage += sizeof(CurveCache) + cache.polyline.capacity() * sizeof(ImVec2) + cache.geometry.GetCapacity();
+         return usage;
+      }
+   };
+
+   // interaction state of an editor, so many editors can be drawn in the same frame
+   struct EditState
+   {
+      bool selectingQuad = false;
+      ImVec2 quadSelection;
+      int overCurve = -1;
+      int movingCurve = -1;
+      bool scrolling = false;
+      ImVector<EditPoint> selection;
+      bool overSelectedPoint = false;
+      EditPoint movingTangent = { -1, -1 };
+      int movingTangentSide = 0;
+      bool pointsMoved = false;
+      ImVec2 mousePosOrigin;
+      Scratch scratch;
+   };
+
+   static ImWidgetStates<EditState> editStates;
+
+   void ClearState()
+   {
+      editStates.Clear();
+   }
+
+   size_t GetScratchPeakUsage(unsigned int id)
+   {
+      const EditState* state = editStates.Find(id);
+      return state ? state->scratch.GetPeakUsage() : 0;
+   }
+
+   // selection is kept sorted so lookups are binary searches and updates don't allocate once grown
+   static int SelectionLowerBound(const ImVector<EditPoint>& selection, const EditPoint& point)
+   {
+      int first = 0;
+      int count = selection.Size;
+      while (count > 0)
+      {
+         const int step = count / 2;
+         if (selection[first + step] < point)
+         {
+            first += step + 1;
+            count -= step + 1;
+         }
+         else
+         {
+            count = step;
+         }
+      }
+      return first;
+   }
+
+   static bool IsSelected(const ImVector<EditPoint>& selection, const EditPoint& point)
+   {
+      const int index = SelectionLowerBound(selection, point);
+      return index < selection.Size && !(point < selection[index]);
+   }
+
+   static void Select(ImVector<EditPoint>& selection, const EditPoint& point)
+   {
+      const int index = SelectionLowerBound(selection, point);
+      if (index == selection.Size || point < selection[index])
+         selection.insert(selection.Data + index, point);
+   }
+
+   static void Unselect(ImVector<EditPoint>& selection, const EditPoint& point)
+   {
+      const int index = SelectionLowerBound(selection, point);
+      if (index < selection.Size && !(point < selection[index]))
+         selection.erase(selection.Data + index);
+   }
+
+   // hidden points are only drawn when hovered or edited
+   static int DrawPoint(ImDrawList* draw_list, ImVec2 pos, const ImVec2 size, const ImVec2 offset, bool edited, bool visible = true)
    {
       int ret = 0;
       ImGuiIO& io = ImGui::GetIO();
@@ -87,13 +419,15 @@ namespace ImCurveEdit
 
       const ImVec2 center = pos * size + offset;
       const ImRect anchor(center - ImVec2(5, 5), center + ImVec2(5, 5));
-      draw_list->AddConvexPolyFilled(offsets, 4, 0xFF000000);
       if (anchor.Contains(io.MousePos))
       {
          ret = 1;
          if (io.MouseDown[0])
             ret = 2;
       }
+      if (!visible && !ret && !edited)
+         return ret;
+      draw_list->AddConvexPolyFilled(offsets, 4, 0xFF000000);
       if (edited)
          draw_list->AddPolyline(offsets, 4, 0xFFFFFFFF, true, 3.0f);
       else if (ret)
@@ -106,13 +440,20 @@ namespace ImCurveEdit
 
    int Edit(Delegate &delegate, const ImVec2& size, unsigned int id, const ImRect *clippingRect, ImVector<EditPoint> *selectedPoints)
    {
-      static bool selectingQuad = false;
-      static ImVec2 quadSelection;
-      static int overCurve = -1;
-      static int movingCurve = -1;
-      static bool scrollingV = false;
-      static std::set<EditPoint> selection;
-      static bool overSelectedPoint = false;
+      IMGUIZMO_PROFILE_ZONE("ImCurveEdit::Edit");
+      EditState& state = editStates.Get(id);
+      bool& selectingQuad = state.selectingQuad;
+      ImVec2& quadSelection = state.quadSelection;
+      int& overCurve = state.overCurve;
+      int& movingCurve = state.movingCurve;
+      bool& scrolling = state.scrolling;
+      ImVector<EditPoint>& selection = state.selection;
+      bool& overSelectedPoint = state.overSelectedPoint;
+      EditPoint& movingTangent = state.movingTangent;
+      int& movingTangentSide = state.movingTangentSide;
+      bool& pointsMoved = state.pointsMoved;
+      ImVec2& mousePosOrigin = state.mousePosOrigin;
+      Scratch& scratch = state.scratch;
 
       int ret = 0;
 
@@ -131,10 +472,24 @@ namespace ImCurveEdit
       ImVec2& min = delegate.GetMin();
       ImVec2& max = delegate.GetMax();
 
-      // handle zoom and VScroll
+      // handle zoom and scroll. Ctrl + wheel zooms horizontally, horizontal wheel pans
       if (container.Contains(io.MousePos))
       {
-          if (fabsf(io.MouseWheel) > FLT_EPSILON)
+          if (fabsf(io.MouseWheel) > FLT_EPSILON && io.KeyCtrl)
+          {
+              // the view spans [min.x, max.x + 1], as in pointToRange
+              const float r = (io.MousePos.x - offset.x) / ssize.x;
+              float ratioX = ImLerp(min.x, max.x + 1.f, r);
+              auto scaleValue = [&](float v) {
+                  v -= ratioX;
+                  v *= (1.f - io.MouseWheel * 0.05f);
+                  v += ratioX;
+                  return v;
+              };
+              min.x = scaleValue(min.x);
+              max.x = scaleValue(max.x + 1.f) - 1.f;
+          }
+          else if (fabsf(io.MouseWheel) > FLT_EPSILON)
           {
               const float r = (io.MousePos.y - offset.y) / ssize.y;
               float ratioY = ImLerp(min.y, max.y, r);
@@ -147,9 +502,15 @@ namespace ImCurveEdit
               min.y = scaleValue(min.y);
               max.y = scaleValue(max.y);
           }
-          if (!scrollingV && ImGui::IsMouseDown(2))
+          if (fabsf(io.MouseWheelH) > FLT_EPSILON)
           {
-              scrollingV = true;
+              const float deltaW = io.MouseWheelH * (max.x + 1.f - min.x) * 0.05f;
+              min.x -= deltaW;
+              max.x -= deltaW;
+          }
+          if (!scrolling && ImGui::IsMouseDown(2))
+          {
+              scrolling = true;
           }
       }
       ImVec2 range = max - min + ImVec2(1.f, 0.f);  // +1 because of inclusive last frame
@@ -158,26 +519,34 @@ namespace ImCurveEdit
       const ImVec2 sizeOfPixel = ImVec2(1.f, 1.f) / viewSize;
       const size_t curveCount = delegate.GetCurveCount();
 
-      if (scrollingV)
+      if (scrolling)
       {
+          float deltaW = io.MouseDelta.x * range.x * sizeOfPixel.x;
           float deltaH = io.MouseDelta.y * range.y * sizeOfPixel.y;
+          min.x -= deltaW;
+          max.x -= deltaW;
           min.y -= deltaH;
           max.y -= deltaH;
           if (!ImGui::IsMouseDown(2))
-              scrollingV = false;
+              scrolling = false;
       }
 
       draw_list->AddRectFilled(offset, offset + ssize, delegate.GetBackgroundColor());
 
       auto pointToRange = [&](ImVec2 pt) { return (pt - min) / range; };
       auto rangeToPoint = [&](ImVec2 pt) { return (pt * range) + min; };
+      const float visibleMinX = rangeToPoint(ImVec2(0.f, 0.f)).x;
+      const float visibleMaxX = rangeToPoint(ImVec2(1.f, 0.f)).x;
 
       draw_list->AddLine(ImVec2(-1.f, -min.y/range.y) * viewSize + offset, ImVec2(1.f, -min.y / range.y) * viewSize + offset, 0xFF000000, 1.5f);
       bool overCurveOrPoint = false;
 
       int localOverCurve = -1;
       // make sure highlighted curve is rendered last
-      int *curvesIndex = (int*)_malloca(sizeof(int) * curveCount);
+      ImVector<int>& curvesIndex = scratch.curvesIndex;
+      curvesIndex.resize(int(curveCount));
+      if (scratch.curveCaches.size() < curveCount)
+         scratch.curveCaches.resize(curveCount);
       for (size_t c = 0; c < curveCount; c++)
           curvesIndex[c] = int(c);
       int highLightedCurveIndex = -1;
@@ -189,6 +558,7 @@ namespace ImCurveEdit
 
       for (size_t cur = 0; cur < curveCount; cur++)
       {
+          IMGUIZMO_PROFILE_ZONE("ImCurveEdit::Curve");
           int c = curvesIndex[cur];
          if (!delegate.IsVisible(c))
             continue;
@@ -203,91 +573,254 @@ namespace ImCurveEdit
          if ((c == highLightedCurveIndex && selection.empty() && !selectingQuad) || movingCurve == c)
             curveColor = 0xFFFFFFFF;
 
-         for (size_t p = 0; p < ptCount - 1; p++)
+         const ImVec2* tangents = (curveType == CurveBezier) ? delegate.GetTangents(c) : NULL;
+
+         // visible points, including the ones right outside so edge segments are drawn
+         const size_t firstPoint = ImMax(FindPointAfter(pts, ptCount, visibleMinX), size_t(1)) - 1;
+         const size_t lastPoint = ImMin(FindPointAfter(pts, ptCount, visibleMaxX), ptCount - 1);
+         // when zoomed out, reduce to first/min/max/last per pixel column so cost is bounded by the width
+         const bool reduceColumns = (lastPoint - firstPoint) > size_t(size.x * 0.5f);
+
+         // re-emit the previous frame geometry when neither the curve nor the view changed
+         CurveCache& cache = scratch.curveCaches[c];
+         CurveKey curveKey;
+         curveKey.delegate = &delegate;
+         curveKey.curveIndex = c;
+         curveKey.points = pts;
+         curveKey.pointCount = ptCount;
+         curveKey.version = delegate.GetCurveVersion(c);
+         curveKey.curveType = curveType;
+         curveKey.color = curveColor;
+         curveKey.thickness = curveThickness;
+         curveKey.drawListFlags = draw_list->Flags;
+         ImVector<ImVec2>& polyline = cache.polyline;
+         if (curveKey.version && cache.key == curveKey && cache.IsSameView(min, range, viewSize, offset))
          {
-            const ImVec2 p1 = pointToRange(pts[p]);
-            const ImVec2 p2 = pointToRange(pts[p+1]);
+            cache.Emit(draw_list);
+         }
+         else
+         {
+            IMGUIZMO_PROFILE_ZONE("ImCurveEdit::Tessellate");
+            polyline.resize(0);
+            if (reduceColumns)
+            {
+               // per visible pixel column: value at both edges, min/max of the keys and of the middle of their segments.
+               // Values come from the segments so every curve type keeps its shape
+               size_t segment = firstPoint;
+               size_t cpSegment = ptCount;
+               ImVec2 cp[4];
+               auto evaluate = [&](float x) { // x never decreases
+                  while (segment + 1 < lastPoint && pts[segment + 1].x <= x)
+                     segment++;
+                  if (cpSegment != segment)
+                  {
+                     GetSegmentControlPoints(curveType, pts, tangents, ptCount, segment, cp);
+                     cpSegment = segment;
+                  }
+                  return EvaluateSegment(curveType, cp, x);
+               };
+               auto columnToX = [&](float column) { return rangeToPoint(ImVec2((column - offset.x) / viewSize.x, 0.f)).x; };
+               auto valueToY = [&](float value) { return pointToRange(ImVec2(0.f, value)).y * viewSize.y + offset.y; };
+
+               const float firstColumn = ImMax(floorf(pointToRange(pts[firstPoint]).x * viewSize.x + offset.x), floorf(offset.x) - 1.f);
+               const float lastColumn = ImMin(floorf(pointToRange(pts[lastPoint]).x * viewSize.x + offset.x), floorf(offset.x + viewSize.x) + 1.f);
+               size_t key = firstPoint;
+               for (float column = firstColumn; column <= lastColumn; column += 1.f)
+               {
+                  const float x0 = ImMax(columnToX(column), pts[firstPoint].x);
+                  const float x1 = ImMin(columnToX(column + 1.f), pts[lastPoint].x);
+                  const float first = evaluate(x0);
+                  float columnMin = first, columnMax = first;
+                  for (; key <= lastPoint && pts[key].x < x1; key++)
+                  {
+                     if (pts[key].x < x0)
+                        continue;
+                     columnMin = ImMin(columnMin, pts[key].y);
+                     columnMax = ImMax(columnMax, pts[key].y);
+                     const float middle = (key < lastPoint) ? (pts[key].x + pts[key + 1].x) * 0.5f : x1;
+                     if (middle < x1)
+                     {
+                        const float value = evaluate(middle);
+                        columnMin = ImMin(columnMin, value);
+                        columnMax = ImMax(columnMax, value);
+                     }
+                  }
+                  const float last = evaluate(x1);
+                  columnMin = ImMin(columnMin, last);
+                  columnMax = ImMax(columnMax, last);
 
-            if (curveType == CurveSmooth || curveType == CurveLinear)
+                  const float columnX = column + 0.5f;
+                  polyline.push_back(ImVec2(columnX, valueToY(first)));
+                  if (columnMin != columnMax)
+                  {
+                     polyline.push_back(ImVec2(columnX, valueToY(columnMin)));
+                     polyline.push_back(ImVec2(columnX, valueToY(columnMax)));
+                  }
+                  polyline.push_back(ImVec2(columnX, valueToY(last)));
+               }
+            }
+            else
             {
-                size_t subStepCount = (curveType == CurveSmooth)?20:2;
-                float step = 1.f / float(subStepCount - 1);
-                for (size_t substep = 0; substep < subStepCount - 1; substep++)
-                {
-                    float t = float(substep) * step;
-
-                    const ImVec2 sp1 = ImLerp(p1, p2, t);
-                    const ImVec2 sp2 = ImLerp(p1, p2, t + step);
-
-                    const float rt1 = smoothstep(p1.x, p2.x, sp1.x);
-                    const float rt2 = smoothstep(p1.x, p2.x, sp2.x);
-
-                    const ImVec2 pos1 = ImVec2(sp1.x, ImLerp(p1.y, p2.y, rt1)) * viewSize + offset;
-                    const ImVec2 pos2 = ImVec2(sp2.x, ImLerp(p1.y, p2.y, rt2)) * viewSize + offset;
-
-                    if (distance(io.MousePos.x, io.MousePos.y, pos1.x, pos1.y, pos2.x, pos2.y) < 8.f && !scrollingV)
-                    {
-                        localOverCurve = int(c);
-                        overCurve = int(c);
-                        overCurveOrPoint = true;
-                    }
-
-                    draw_list->AddLine(pos1, pos2, curveColor, 1.3f);
-                } // substep
+               for (size_t p = firstPoint; p < lastPoint; p++)
+               {
+                  if (curveType == CurveDiscrete)
+                  {
+                     const ImVec2 p1 = pointToRange(pts[p]);
+                     const ImVec2 p2 = pointToRange(pts[p + 1]);
+                     if (polyline.empty())
+                        polyline.push_back(p1 * viewSize + offset);
+                     polyline.push_back(ImVec2(p2.x, p1.y) * viewSize + offset);
+                     polyline.push_back(p2 * viewSize + offset);
+                     continue;
+                  }
+
+                  ImVec2 cp[4];
+                  GetSegmentControlPoints(curveType, pts, tangents, ptCount, p, cp);
+                  for (int i = 0; i < 4; i++)
+                     cp[i] = pointToRange(cp[i]) * viewSize + offset;
+                  if (polyline.empty())
+                     polyline.push_back(cp[0]);
+                  TessellateBezier(polyline, cp[0], cp[1], cp[2], cp[3], 0);
+               } // point loop
             }
-            else if (curveType == CurveDiscrete)
+
+            cache.bounds = ImRect();
+            for (const ImVec2& pt : polyline)
+               cache.bounds.Add(pt);
+            if (curveKey.version)
+               cache.Capture(draw_list, curveColor);
+            else if (polyline.Size > 1)
+               draw_list->AddPolyline(polyline.Data, polyline.Size, curveColor, false, curveThickness);
+            cache.key = curveKey;
+            cache.SetView(min, range, viewSize, offset);
+         }
+
+         if (polyline.Size > 1 && !scrolling)
+         {
+            ImRect hoverBounds = cache.bounds;
+            hoverBounds.Expand(8.f);
+            if (hoverBounds.Contains(io.MousePos))
             {
-                ImVec2 dp1 = p1 * viewSize + offset;
-                ImVec2 dp2 = ImVec2(p2.x, p1.y) * viewSize + offset;
-                ImVec2 dp3 = p2 * viewSize + offset;
-                draw_list->AddLine(dp1, dp2, curveColor, 1.3f);
-                draw_list->AddLine(dp2, dp3, curveColor, 1.3f);
-
-                if ( (distance(io.MousePos.x, io.MousePos.y, dp1.x, dp1.y, dp3.x, dp1.y) < 8.f ||
-                    distance(io.MousePos.x, io.MousePos.y, dp3.x, dp1.y, dp3.x, dp3.y) < 8.f )
-                    /*&& localOverCurve == -1*/)
-                {
-                    localOverCurve = int(c);
-                    overCurve = int(c);
-                    overCurveOrPoint = true;
-                }
+               for (int i = 0; i < polyline.Size - 1; i++)
+               {
+                  if (distance(io.MousePos.x, io.MousePos.y, polyline[i].x, polyline[i].y, polyline[i + 1].x, polyline[i + 1].y) < 8.f)
+                  {
+                     localOverCurve = int(c);
+                     overCurve = int(c);
+                     overCurveOrPoint = true;
+                     break;
+                  }
+               }
             }
-         } // point loop
+         }
 
-         for (size_t p = 0; p < ptCount; p++)
+         // tangent handles of selected points
+         if (tangents)
          {
-            const int drawState = DrawPoint(draw_list, pointToRange(pts[p]), viewSize, offset, (selection.find({int(c), int(p)}) != selection.end() && movingCurve == -1 && !scrollingV));
-            if (drawState && movingCurve == -1 && !selectingQuad)
+            // walk the selected points of the curve in view rather than every point
+            for (int s = SelectionLowerBound(selection, { int(c), int(firstPoint) }); s < selection.Size && selection[s].curveIndex == int(c) && selection[s].pointIndex <= int(lastPoint); s++)
+            {
+               const size_t p = size_t(selection[s].pointIndex);
+               const ImVec2 center = pointToRange(pts[p]) * viewSize + offset;
+               for (int side = 0; side < 2; side++)
+               {
+                  if ((side == 0 && p == 0) || (side == 1 && p == ptCount - 1))
+                     continue;
+                  const ImVec2 handle = pointToRange(pts[p] + tangents[p * 2 + side]) * viewSize + offset;
+                  const bool overHandle = ImLengthSqr(io.MousePos - handle) < 25.f;
+                  const bool editedHandle = movingTangent.curveIndex == int(c) && movingTangent.pointIndex == int(p) && movingTangentSide == side;
+                  draw_list->AddLine(center, handle, 0xFFAAAAAA, 1.f);
+                  draw_list->AddCircleFilled(handle, 3.5f, (overHandle || editedHandle) ? 0xFF80B0FF : 0xFF0080FF);
+                  if (overHandle && movingCurve == -1 && !selectingQuad)
+                  {
+                     overCurveOrPoint = true;
+                     if (ImGui::IsMouseClicked(0) && movingTangent.curveIndex == -1)
+                     {
+                        movingTangent = { int(c), int(p) };
+                        movingTangentSide = side;
+                        delegate.BeginEdit(int(c));
+                     }
+                  }
+               }
+            }
+         }
+
+         const bool showSelection = movingCurve == -1 && !scrolling;
+         auto handlePoint = [&](size_t p, bool visible) {
+            const int drawState = DrawPoint(draw_list, pointToRange(pts[p]), viewSize, offset, (IsSelected(selection, { int(c), int(p) }) && showSelection), visible);
+            if (drawState && movingCurve == -1 && !selectingQuad && movingTangent.curveIndex == -1)
             {
                overCurveOrPoint = true;
                overSelectedPoint = true;
                overCurve = -1;
                if (drawState == 2)
                {
-                  if (!io.KeyShift && selection.find({ int(c), int(p) }) == selection.end())
-                     selection.clear();
-                  selection.insert({ int(c), int(p) });
+                  if (!io.KeyShift && !IsSelected(selection, { int(c), int(p) }))
+                     selection.resize(0);
+                  Select(selection, { int(c), int(p) });
                }
             }
+         };
+
+         if (!reduceColumns)
+         {
+            for (size_t p = firstPoint; p <= lastPoint; p++)
+               handlePoint(p, true);
+            continue;
          }
+
+         // zoomed out: one marker per 8 pixels bucket, the first key in it. Only the keys under the mouse are
+         // hit-tested and other hidden keys are only drawn when selected, so cost is bounded by the width
+         static const float markerSpacing = 8.f;
+         auto pointToScreenX = [&](size_t p) { return pointToRange(pts[p]).x * viewSize.x + offset.x; };
+         auto screenToX = [&](float screenX) { return rangeToPoint(ImVec2((screenX - offset.x) / viewSize.x, 0.f)).x; };
+         auto bucket = [&](size_t p) { return floorf((pointToScreenX(p) - offset.x) / markerSpacing); };
+         auto isMarker = [&](size_t p) { return p == firstPoint || bucket(p) != bucket(p - 1); };
+         const size_t hitFirst = ImMax(FindPointAfter(pts, ptCount, screenToX(io.MousePos.x - 6.f)), firstPoint);
+         const size_t hitLast = ImMin(FindPointAfter(pts, ptCount, screenToX(io.MousePos.x + 6.f)), lastPoint + 1);
+         auto isHitTested = [&](size_t p) { return p >= hitFirst && p < hitLast; };
+
+         for (size_t p = firstPoint; p <= lastPoint;)
+         {
+            if (!isHitTested(p))
+               DrawPoint(draw_list, pointToRange(pts[p]), viewSize, offset, IsSelected(selection, { int(c), int(p) }) && showSelection);
+            // jump to the first key of the next bucket, the search is refined against rounding
+            const float markerBucket = bucket(p);
+            size_t next = ImMax(FindPointAfter(pts, ptCount, screenToX(offset.x + (markerBucket + 1.f) * markerSpacing)), p + 1);
+            while (next > p + 1 && bucket(next - 1) != markerBucket)
+               next--;
+            while (next <= lastPoint && bucket(next) == markerBucket)
+               next++;
+            p = next;
+         }
+         if (showSelection)
+         {
+            for (int s = SelectionLowerBound(selection, { int(c), int(firstPoint) }); s < selection.Size && selection[s].curveIndex == int(c) && selection[s].pointIndex <= int(lastPoint); s++)
+            {
+               const size_t p = size_t(selection[s].pointIndex);
+               if (!isHitTested(p) && !isMarker(p))
+                  DrawPoint(draw_list, pointToRange(pts[p]), viewSize, offset, true, false);
+            }
+         }
+         for (size_t p = hitFirst; p < hitLast; p++)
+            handlePoint(p, isMarker(p));
       } // curves loop
 
       if (localOverCurve == -1)
          overCurve = -1;
 
       // move selection
-      static bool pointsMoved = false;
-      static ImVec2 mousePosOrigin;
-      static std::vector<ImVec2> originalPoints;
-      if (overSelectedPoint && io.MouseDown[0])
+      ImVector<ImVec2>& originalPoints = scratch.originalPoints;
+      if (overSelectedPoint && io.MouseDown[0] && movingTangent.curveIndex == -1)
       {
+          IMGUIZMO_PROFILE_ZONE("ImCurveEdit::MoveSelection");
           if (fabsf(io.MouseDelta.x) > 0.f || fabsf(io.MouseDelta.y) > 0.f && !selection.empty())
           {
               if (!pointsMoved)
               {
                   delegate.BeginEdit(0);
                   mousePosOrigin = io.MousePos;
-                  originalPoints.resize(selection.size());
+                  originalPoints.resize(selection.Size);
                   int index = 0;
                   for (auto& sel : selection)
                   {
@@ -297,7 +830,10 @@ namespace ImCurveEdit
               }
               pointsMoved = true;
               ret = 1;
-              auto prevSelection = selection;
+              ImVector<EditPoint>& prevSelection = scratch.movedSelection;
+              prevSelection.resize(selection.Size);
+              for (int i = 0; i < selection.Size; i++)
+                  prevSelection[i] = selection[i];
               int originalIndex = 0;
               for (auto& sel : prevSelection)
               {
@@ -306,8 +842,8 @@ namespace ImCurveEdit
                   const int newIndex = delegate.EditPoint(sel.curveIndex, sel.pointIndex, p);
                   if (newIndex != sel.pointIndex)
                   {
-                      selection.erase(sel);
-                      selection.insert({ sel.curveIndex, newIndex });
+                      Unselect(selection, sel);
+                      Select(selection, { sel.curveIndex, newIndex });
                   }
                   originalIndex++;
               }
@@ -324,6 +860,20 @@ namespace ImCurveEdit
           }
       }
 
+      // move tangent handle
+      if (movingTangent.curveIndex != -1)
+      {
+         const ImVec2* pts = delegate.GetPoints(movingTangent.curveIndex);
+         const ImVec2 handle = rangeToPoint((io.MousePos - offset) / viewSize) - pts[movingTangent.pointIndex];
+         delegate.EditTangent(movingTangent.curveIndex, movingTangent.pointIndex, movingTangentSide, handle);
+         ret = 1;
+         if (!io.MouseDown[0])
+         {
+            movingTangent = { -1, -1 };
+            delegate.EndEdit();
+         }
+      }
+
       // add point
       if (overCurve != -1 && io.MouseDoubleClicked[0])
       {
@@ -344,7 +894,7 @@ namespace ImCurveEdit
          {
              mousePosOrigin = io.MousePos;
              pointsMoved = true;
-             originalPoints.resize(ptCount);
+             originalPoints.resize(int(ptCount));
              for (size_t index = 0;index< ptCount;index++)
              {
                  originalPoints[index] = pts[index];
@@ -381,8 +931,9 @@ namespace ImCurveEdit
          const ImRect selectionQuad(bmin, bmax);
          if (!io.MouseDown[0])
          {
+            IMGUIZMO_PROFILE_ZONE("ImCurveEdit::QuadSelection");
             if (!io.KeyShift)
-               selection.clear();
+               selection.resize(0);
             // select everythnig is quad
             for (size_t c = 0; c < curveCount; c++)
             {
@@ -394,11 +945,15 @@ namespace ImCurveEdit
                   continue;
 
                const ImVec2* pts = delegate.GetPoints(c);
-               for (size_t p = 0; p < ptCount; p++)
+               const float quadMinX = rangeToPoint((bmin - offset) / viewSize).x;
+               const float quadMaxX = rangeToPoint((bmax - offset) / viewSize).x;
+               const size_t firstPoint = ImMax(FindPointAfter(pts, ptCount, quadMinX), size_t(1)) - 1;
+               const size_t lastPoint = ImMin(FindPointAfter(pts, ptCount, quadMaxX), ptCount - 1);
+               for (size_t p = firstPoint; p <= lastPoint; p++)
                {
                   const ImVec2 center = pointToRange(pts[p]) * viewSize + offset;
                   if (selectionQuad.Contains(center))
-                     selection.insert({int(c), int(p)});
+                     Select(selection, { int(c), int(p) });
                }
             }
             // done
@@ -419,7 +974,7 @@ namespace ImCurveEdit
 
       if (selectedPoints)
       {
-          selectedPoints->resize(int(selection.size()));
+          selectedPoints->resize(selection.Size);
           int index = 0;
           for (auto& point : selection)
               (*selectedPoints)[index++] = point;
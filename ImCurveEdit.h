@@ -42,6 +42,7 @@ namespace ImCurveEdit
         virtual ImVec2& GetMax() = 0;
         virtual size_t GetPointCount(size_t curveIndex) = 0;
         virtual uint32_t GetCurveColor(size_t curveIndex) = 0;
+        // points are expected to be sorted on x
         virtual ImVec2* GetPoints(size_t curveIndex) = 0;
         virtual int EditPoint(size_t curveIndex, int pointIndex, ImVec2 value) = 0;
         virtual void AddPoint(size_t curveIndex, ImVec2 value) = 0;
@@ -49,7 +50,32 @@ namespace ImCurveEdit
         // handle undo/redo thru this functions
         virtual void BeginEdit(int /*index*/) {}
         virtual void EndEdit() {}
+        // CurveBezier tangent handles: 2 per point (in, out), offsets from the point in curve space.
+        // When NULL, Hermite tangents are derived from the neighbouring points (Catmull-Rom)
+        virtual ImVec2* GetTangents(size_t /*curveIndex*/) { return NULL; }
+        virtual void EditTangent(size_t /*curveIndex*/, int /*pointIndex*/, int /*tangentIndex*/, ImVec2 /*value*/) {}
+        // bump the returned value whenever the curve points, tangents or type change so the editor can
+        // reuse the previous frame tessellation. 0 means unversioned: the curve is tessellated every frame.
+        // The cache is per curve index: a curve moved to another index must not keep a version that the curve
+        // previously there had, a global counter shared by all curves avoids that
+        virtual unsigned int GetCurveVersion(size_t /*curveIndex*/) { return 0; }
     };
 
+    // id identifies the editor: selection and drag state are kept per id.
+    // wheel zooms vertically, ctrl + wheel horizontally. Middle mouse button pans.
     int Edit(Delegate &delegate, const ImVec2& size, unsigned int id, const ImRect *clippingRect = NULL, ImVector<EditPoint> *selectedPoints = NULL);
+    // frees the state of every editor, in every ImGui context. Call it before destroying the ImGui context
+    void ClearState();
+    // peak size in bytes of the transient storage used by the editor with that id
+    size_t GetScratchPeakUsage(unsigned int id);
+
+    // cubic Bezier control points (4) of the segment [pointIndex, pointIndex + 1], in curve space.
+    // Linear, smooth and Hermite segments are expressed as Bezier segments as well.
+    void GetSegmentControlPoints(Delegate &delegate, size_t curveIndex, size_t pointIndex, ImVec2 *controlPoints);
+    // same from the curve data already queried from the delegate, tangents being NULL unless the curve is CurveBezier
+    void GetSegmentControlPoints(CurveType curveType, const ImVec2 *points, const ImVec2 *tangents, size_t pointCount, size_t pointIndex, ImVec2 *controlPoints);
+    // value at x of a segment returned by GetSegmentControlPoints
+    float EvaluateSegment(CurveType curveType, const ImVec2 *controlPoints, float x);
+    // value of the curve at x, same as displayed by Edit. Clamped to the first/last point outside the curve.
+    float Evaluate(Delegate &delegate, size_t curveIndex, float x);
 }
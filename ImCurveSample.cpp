@@ -0,0 +1,148 @@
+#include "ImCurveSample.h"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <math.h>
+
+namespace ImCurveEdit
+{
+   // values of a segment for a run of x values inside it.
+   // x is linear in t for every segment but Bezier ones with user handles, so t is direct
+   static void SampleSegmentRun(CurveType curveType, const ImVec2* cp, bool linearX, const float* x, float* y, size_t count)
+   {
+      if (curveType == CurveDiscrete)
+      {
+         for (size_t i = 0; i < count; i++)
+            y[i] = (x[i] < cp[3].x) ? cp[0].y : cp[3].y;
+         return;
+      }
+      if (!linearX)
+      {
+         for (size_t i = 0; i < count; i++)
+            y[i] = EvaluateSegment(curveType, cp, x[i]);
+         return;
+      }
+
+      const float dx = cp[3].x - cp[0].x;
+      const float invDx = (dx > FLT_EPSILON) ? 1.f / dx : 0.f;
+      const float x0 = cp[0].x;
+      const float a = cp[0].y;
+      const float b = cp[1].y;
+      const float c = cp[2].y;
+      const float d = cp[3].y;
+      for (size_t i = 0; i < count; i++)
+      {
+         const float t = ImClamp((x[i] - x0) * invDx, 0.f, 1.f);
+         const float it = 1.f - t;
+         y[i] = it * it * it * a + 3.f * it * it * t * b + 3.f * it * t * t * c + t * t * t * d;
+      }
+   }
+
+   // curve data queried once from the delegate, sampled by runs of ascending x values
+   struct CurveSampler
+   {
+      CurveSampler(Delegate &delegate, size_t curveIndex)
+      {
+         ptCount = delegate.GetPointCount(curveIndex);
+         pts = ptCount ? delegate.GetPoints(curveIndex) : NULL;
+         curveType = delegate.GetCurveType(curveIndex);
+         tangents = (curveType == CurveBezier) ? delegate.GetTangents(curveIndex) : NULL;
+         linearX = (curveType != CurveBezier) || !tangents;
+      }
+
+      // x values continue the previous run: the segment walk resumes where it stopped
+      void Sample(const float* x, float* y, size_t count)
+      {
+         if (!ptCount)
+         {
+            for (size_t i = 0; i < count; i++)
+               y[i] = 0.f;
+            return;
+         }
+
+         size_t i = 0;
+         // before the first point
+         while (i < count && x[i] <= pts[0].x)
+            y[i++] = pts[0].y;
+
+         // walk segments monotonically
+         while (i < count && segment < ptCount - 1)
+         {
+            const float segmentEnd = pts[segment + 1].x;
+            size_t runEnd = i;
+            while (runEnd < count && x[runEnd] < segmentEnd)
+               runEnd++;
+            if (runEnd > i)
+            {
+               ImVec2 cp[4];
+               GetSegmentControlPoints(curveType, pts, tangents, ptCount, segment, cp);
+               SampleSegmentRun(curveType, cp, linearX, x + i, y + i, runEnd - i);
+               i = runEnd;
+            }
+            // the next run may still start inside this segment
+            if (i < count)
+               segment++;
+         }
+
+         // after the last point
+         for (; i < count; i++)
+            y[i] = pts[ptCount - 1].y;
+      }
+
+      const ImVec2* pts;
+      size_t ptCount;
+      CurveType curveType;
+      const ImVec2* tangents;
+      bool linearX;
+      size_t segment = 0;
+   };
+
+   void Sample(Delegate &delegate, size_t curveIndex, const float *x, float *y, size_t count)
+   {
+      CurveSampler sampler(delegate, curveIndex);
+      sampler.Sample(x, y, count);
+   }
+
+   float Bake(Delegate &delegate, size_t curveIndex, float minX, float maxX, float *lut, size_t resolution)
+   {
+      if (resolution < 2)
+      {
+         if (resolution)
+            lut[0] = Evaluate(delegate, curveIndex, minX);
+         return 0.f;
+      }
+
+      // LUT entries and the 3 quarter points between each pair of entries, sampled by chunks of entries
+      // in stack buffers. Consecutive chunks share their boundary entry
+      static const int subSamples = 4;
+      static const size_t chunkEntries = 64;
+      float xs[chunkEntries * subSamples + 1];
+      float ys[chunkEntries * subSamples + 1];
+      const size_t sampleCount = (resolution - 1) * subSamples + 1;
+      const float step = (maxX - minX) / float(sampleCount - 1);
+      CurveSampler sampler(delegate, curveIndex);
+
+      float maxError = 0.f;
+      for (size_t first = 0; first < resolution - 1; first += chunkEntries)
+      {
+         const size_t entries = ImMin(chunkEntries, resolution - 1 - first);
+         const size_t count = entries * subSamples + 1;
+         for (size_t i = 0; i < count; i++)
+            xs[i] = minX + float(first * subSamples + i) * step;
+         if (first + entries == resolution - 1)
+            xs[count - 1] = maxX;
+         sampler.Sample(xs, ys, count);
+
+         for (size_t i = 0; i <= entries; i++)
+            lut[first + i] = ys[i * subSamples];
+         for (size_t i = 0; i < entries; i++)
+         {
+            for (int j = 1; j < subSamples; j++)
+            {
+               const float interpolated = ImLerp(lut[first + i], lut[first + i + 1], float(j) / float(subSamples));
+               maxError = ImMax(maxError, fabsf(interpolated - ys[i * subSamples + j]));
+            }
+         }
+      }
+      return maxError;
+   }
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include <stddef.h>
+#include "ImCurveEdit.h"
+
+namespace ImCurveEdit
+{
+    // evaluate a curve for count x values sorted in ascending order, in one pass over its segments.
+    // Values match Evaluate() and what Edit displays.
+    void Sample(Delegate &delegate, size_t curveIndex, const float *x, float *y, size_t count);
+
+    // bake a curve over [minX, maxX] into resolution evenly spaced values (resolution >= 2).
+    // returns the maximum error of linearly interpolating the LUT, measured between consecutive entries
+    float Bake(Delegate &delegate, size_t curveIndex, float minX, float maxX, float *lut, size_t resolution);
+}
@@ -1,7 +1,9 @@
 #include "ImGradient.h"
+#include "ImGuizmoState.h"
 #include "imgui.h"
 #include "imgui_internal.h"
 #include <stdint.h>
+#include <string.h>
 #include <set>
 
 namespace ImGradient
@@ -15,15 +17,30 @@ namespace ImGradient
    static inline ImVec2 operator/(const ImVec2& lhs, const ImVec2& rhs) { return ImVec2(lhs.x / rhs.x, lhs.y / rhs.y); }
 #endif
 
-   static int DrawPoint(ImDrawList* draw_list, ImVec4 color, const ImVec2 size, bool editing, ImVec2 pos)
+   // t of a stop maps to the center of its marker: markers are size.y wide and stay inside the widget
+   static float GetRampX(const ImVec2& pos, const ImVec2& size, float t)
+   {
+      return pos.x + size.y * 0.5f + t * (size.x - size.y);
+   }
+
+   static float GetRampT(const ImVec2& pos, const ImVec2& size, float x)
+   {
+      return (size.x > size.y) ? ImSaturate((x - pos.x - size.y * 0.5f) / (size.x - size.y)) : 0.f;
+   }
+
+   // visible markers are drawn, hidden ones only hit-tested
+   static int DrawPoint(ImDrawList* draw_list, ImVec4 color, const ImVec2 size, bool editing, ImVec2 pos, bool visible = true)
    {
       int ret = 0;
       ImGuiIO& io = ImGui::GetIO();
 
-      ImVec2 p1 = ImLerp(pos, ImVec2(pos + ImVec2(size.x - size.y, 0.f)), color.w) + ImVec2(3, 3);
-      ImVec2 p2 = ImLerp(pos + ImVec2(size.y, size.y), ImVec2(pos + size), color.w) - ImVec2(3, 3);
+      const float x = GetRampX(pos, size, color.w);
+      ImVec2 p1 = ImVec2(x - size.y * 0.5f, pos.y) + ImVec2(3, 3);
+      ImVec2 p2 = ImVec2(x + size.y * 0.5f, pos.y + size.y) - ImVec2(3, 3);
       ImRect rc(p1, p2);
 
+      if (!visible)
+         return rc.Contains(io.MousePos) ? (io.MouseClicked[0] ? 2 : 1) : 0;
       color.w = 1.f;
       draw_list->AddRectFilled(p1, p2, ImColor(color));
       if (editing)
@@ -40,34 +57,110 @@ namespace ImGradient
       return 0;
    }
 
-   bool Edit(Delegate &delegate, const ImVec2& size, int& selection)
+   // preview ramp, one color per few pixels of the widget width
+   struct RampCache
+   {
+      unsigned int version = 0;
+      ImVector<ImU32> colors;
+   };
+
+   static void DrawRamp(ImDrawList* draw_list, Delegate& delegate, RampCache* cache, const ImVec2& pos, const ImVec2& size)
+   {
+      const float rampMin = GetRampX(pos, size, 0.f);
+      const float rampMax = GetRampX(pos, size, 1.f);
+      const int resolution = ImClamp(int((rampMax - rampMin) / 4.f), 2, 1024);
+      const unsigned int version = delegate.GetVersion();
+      if (!version || version != cache->version || cache->colors.Size != resolution)
+      {
+         cache->colors.resize(resolution);
+         for (int i = 0; i < resolution; i++)
+         {
+            ImVec4 color = delegate.GetPoint(float(i) / float(resolution - 1));
+            color.w = 1.f;
+            cache->colors[i] = ImColor(color);
+         }
+         cache->version = version;
+      }
+
+      // the margins under the first and last half markers show the end colors
+      draw_list->AddRectFilled(pos, ImVec2(rampMin, pos.y + size.y), cache->colors[0]);
+      draw_list->AddRectFilled(ImVec2(rampMax, pos.y), pos + size, cache->colors[resolution - 1]);
+      const float step = (rampMax - rampMin) / float(resolution - 1);
+      for (int i = 0; i < resolution - 1; i++)
+      {
+         const ImU32 left = cache->colors[i];
+         const ImU32 right = cache->colors[i + 1];
+         const float x = rampMin + step * float(i);
+         draw_list->AddRectFilledMultiColor(ImVec2(x, pos.y), ImVec2(x + step, pos.y + size.y), left, right, right, left);
+      }
+   }
+
+   // markers are thinned to the first stop in each few pixels wide column, so many stops keep a bounded draw cost
+   static const float markerSpacing = 4.f;
+
+   // selection, drag and ramp of one editor
+   struct EditState
+   {
+      int currentSelection = -1;
+      int movingPt = -1;
+      RampCache ramp;
+      ImVector<bool> markerColumns;
+   };
+
+   static ImWidgetStates<EditState> editStates;
+
+   void ClearState()
+   {
+      editStates.Clear();
+   }
+
+   bool Edit(Delegate &delegate, const ImVec2& size, int& selection, unsigned int id)
    {
+      EditState& state = editStates.Get(id);
       bool ret = false;
       ImGuiIO& io = ImGui::GetIO();
       ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0, 0));
-      ImGui::BeginChildFrame(137, size);
+      ImGui::BeginChildFrame(id, size);
 
       ImDrawList* draw_list = ImGui::GetWindowDrawList();
       const ImVec2 offset = ImGui::GetCursorScreenPos();
 
       const ImVec4* pts = delegate.GetPoints();
-      static int currentSelection = -1;
-      static int movingPt = -1;
+      int& currentSelection = state.currentSelection;
+      int& movingPt = state.movingPt;
       if (currentSelection >= int(delegate.GetPointCount()))
          currentSelection = -1;
+      if (movingPt >= int(delegate.GetPointCount()))
+         movingPt = -1;
       if (movingPt != -1)
       {
          ImVec4 current = pts[movingPt];
-         current.w += io.MouseDelta.x / size.x;
+         current.w += io.MouseDelta.x / ImMax(size.x - size.y, 1.f);
          current.w = ImClamp(current.w, 0.f, 1.f);
-         delegate.EditPoint(movingPt, current);
+         // EditPoint returns the point index once the delegate reordered its points, out of range values keep the index
+         const int pointCount = int(delegate.GetPointCount());
+         int movedIndex = delegate.EditPoint(movingPt, current);
+         if (movedIndex < 0 || movedIndex >= pointCount)
+            movedIndex = ImMin(movingPt, pointCount - 1);
+         if (currentSelection == movingPt)
+            currentSelection = movedIndex;
+         movingPt = movedIndex;
+         pts = delegate.GetPoints();
          ret = true;
          if (!io.MouseDown[0])
             movingPt = -1;
       }
+      DrawRamp(draw_list, delegate, &state.ramp, offset, size);
+      // stops are not required to be sorted, so taken columns are flagged
+      ImVector<bool>& markerColumns = state.markerColumns;
+      markerColumns.resize(int(size.x / markerSpacing) + 1);
+      memset(markerColumns.Data, 0, markerColumns.Size * sizeof(bool));
       for (size_t i = 0; i < delegate.GetPointCount(); i++)
       {
-         int ptSel = DrawPoint(draw_list, pts[i], size, i == currentSelection, offset);
+         const int column = ImClamp(int((GetRampX(offset, size, pts[i].w) - offset.x) / markerSpacing), 0, markerColumns.Size - 1);
+         const bool visible = !markerColumns[column] || int(i) == currentSelection || int(i) == movingPt;
+         markerColumns[column] = true;
+         int ptSel = DrawPoint(draw_list, pts[i], size, i == currentSelection, offset, visible);
          if (ptSel == 2)
          {
             currentSelection = int(i);
@@ -81,7 +174,7 @@ namespace ImGradient
       ImRect rc(offset, offset + size);
       if (rc.Contains(io.MousePos) && io.MouseDoubleClicked[0])
       {
-         float t = (io.MousePos.x - offset.x) / size.x;
+         float t = GetRampT(offset, size, io.MousePos.x);
          delegate.AddPoint(delegate.GetPoint(t));
          ret = true;
       }
@@ -10,10 +10,17 @@ namespace ImGradient
    {
       virtual size_t GetPointCount() = 0;
       virtual ImVec4* GetPoints() = 0;
+      // returns the index of the point after the edit: pointIndex, or its new index when the delegate keeps points sorted.
+      // Values outside [0, GetPointCount()) are ignored and pointIndex is kept
       virtual int EditPoint(int pointIndex, ImVec4 value) = 0;
       virtual ImVec4 GetPoint(float t) = 0;
       virtual void AddPoint(ImVec4 value) = 0;
+      // optional, changes whenever the points change so the preview ramp is only rebuilt then. 0 rebuilds it every frame
+      virtual unsigned int GetVersion() { return 0; }
    };
 
-   bool Edit(Delegate &delegate, const ImVec2& size, int& selection);
+   // selection and drag state are kept per id, so several editors can be shown at once
+   bool Edit(Delegate &delegate, const ImVec2& size, int& selection, unsigned int id = 137);
+   // frees the state of every editor, in every ImGui context. Call it before destroying the ImGui context
+   void ClearState();
 }
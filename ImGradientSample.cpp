@@ -0,0 +1,141 @@
+#include "ImGradientSample.h"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <math.h>
+
+namespace ImGradient
+{
+   static float SRGBToLinear(float value)
+   {
+      return (value <= 0.04045f) ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f);
+   }
+
+   static float LinearToSRGB(float value)
+   {
+      return (value <= 0.0031308f) ? value * 12.92f : 1.055f * powf(value, 1.f / 2.4f) - 0.055f;
+   }
+
+   // stop color to the space it is interpolated in
+   static ImVec4 ToWorkingSpace(const ImVec4& color, Interpolation interpolation)
+   {
+      if (interpolation == InterpolationLinear)
+         return color;
+      const float r = SRGBToLinear(color.x);
+      const float g = SRGBToLinear(color.y);
+      const float b = SRGBToLinear(color.z);
+      if (interpolation == InterpolationSRGB)
+         return ImVec4(r, g, b, color.w);
+
+      const float l = cbrtf(0.4122214708f * r + 0.5363325363f * g + 0.0514459929f * b);
+      const float m = cbrtf(0.2119034982f * r + 0.6806995451f * g + 0.1073969566f * b);
+      const float s = cbrtf(0.0883024619f * r + 0.2817188376f * g + 0.6299787005f * b);
+      return ImVec4(0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s,
+         1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s,
+         0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s,
+         color.w);
+   }
+
+   static ImVec4 FromWorkingSpace(const ImVec4& color, Interpolation interpolation)
+   {
+      if (interpolation == InterpolationLinear)
+         return ImVec4(color.x, color.y, color.z, 1.f);
+      float r = color.x;
+      float g = color.y;
+      float b = color.z;
+      if (interpolation == InterpolationOKLab)
+      {
+         const float l = color.x + 0.3963377774f * color.y + 0.2158037573f * color.z;
+         const float m = color.x - 0.1055613458f * color.y - 0.0638541728f * color.z;
+         const float s = color.x - 0.0894841775f * color.y - 1.2914855480f * color.z;
+         const float l3 = l * l * l;
+         const float m3 = m * m * m;
+         const float s3 = s * s * s;
+         r = 4.0767416621f * l3 - 3.3077115913f * m3 + 0.2309699292f * s3;
+         g = -1.2684380046f * l3 + 2.6097574011f * m3 - 0.3413193965f * s3;
+         b = -0.0041960863f * l3 - 0.7034186147f * m3 + 1.7076147010f * s3;
+      }
+      return ImVec4(LinearToSRGB(ImSaturate(r)), LinearToSRGB(ImSaturate(g)), LinearToSRGB(ImSaturate(b)), 1.f);
+   }
+
+   void Sample(const ImVec4* stops, size_t stopCount, const float* t, ImVec4* colors, size_t count, Interpolation interpolation)
+   {
+      if (!stopCount)
+      {
+         for (size_t i = 0; i < count; i++)
+            colors[i] = ImVec4(0.f, 0.f, 0.f, 1.f);
+         return;
+      }
+      const ImVec4 first = ImVec4(stops[0].x, stops[0].y, stops[0].z, 1.f);
+      const ImVec4 last = ImVec4(stops[stopCount - 1].x, stops[stopCount - 1].y, stops[stopCount - 1].z, 1.f);
+
+      // segment [stops[segment - 1], stops[segment]], its ends converted once
+      size_t segment = 0;
+      ImVec4 a, b;
+      for (size_t i = 0; i < count; i++)
+      {
+         const float x = t[i];
+         if (x <= stops[0].w)
+         {
+            colors[i] = first;
+            continue;
+         }
+         if (x >= stops[stopCount - 1].w)
+         {
+            colors[i] = last;
+            continue;
+         }
+         if (!segment || x > stops[segment].w)
+         {
+            if (!segment)
+               segment = 1;
+            while (x > stops[segment].w)
+               segment++;
+            a = ToWorkingSpace(stops[segment - 1], interpolation);
+            b = ToWorkingSpace(stops[segment], interpolation);
+         }
+         const float width = b.w - a.w;
+         const float ratio = (width > FLT_EPSILON) ? (x - a.w) / width : 1.f;
+         colors[i] = FromWorkingSpace(ImLerp(a, b, ratio), interpolation);
+      }
+   }
+
+   // bakes in chunks so the t and color scratch stays on the stack
+   template<typename Store> static void Bake(const ImVec4* stops, size_t stopCount, size_t resolution, Interpolation interpolation, Store store)
+   {
+      const size_t chunkSize = 256;
+      float t[chunkSize];
+      ImVec4 colors[chunkSize];
+      const float step = (resolution > 1) ? 1.f / float(resolution - 1) : 0.f;
+      for (size_t base = 0; base < resolution; base += chunkSize)
+      {
+         const size_t count = ImMin(chunkSize, resolution - base);
+         for (size_t i = 0; i < count; i++)
+            t[i] = float(base + i) * step;
+         Sample(stops, stopCount, t, colors, count, interpolation);
+         for (size_t i = 0; i < count; i++)
+            store(base + i, colors[i]);
+      }
+   }
+
+   void BakeRGBA32F(const ImVec4* stops, size_t stopCount, float* rgba, size_t resolution, Interpolation interpolation)
+   {
+      Bake(stops, stopCount, resolution, interpolation, [rgba](size_t index, const ImVec4& color) {
+         float* texel = rgba + index * 4;
+         texel[0] = color.x;
+         texel[1] = color.y;
+         texel[2] = color.z;
+         texel[3] = color.w;
+      });
+   }
+
+   void BakeRGBA8(const ImVec4* stops, size_t stopCount, unsigned char* rgba, size_t resolution, Interpolation interpolation)
+   {
+      Bake(stops, stopCount, resolution, interpolation, [rgba](size_t index, const ImVec4& color) {
+         unsigned char* texel = rgba + index * 4;
+         texel[0] = (unsigned char)(ImSaturate(color.x) * 255.f + 0.5f);
+         texel[1] = (unsigned char)(ImSaturate(color.y) * 255.f + 0.5f);
+         texel[2] = (unsigned char)(ImSaturate(color.z) * 255.f + 0.5f);
+         texel[3] = (unsigned char)(ImSaturate(color.w) * 255.f + 0.5f);
+      });
+   }
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <stddef.h>
+
+struct ImVec4;
+
+namespace ImGradient
+{
+   enum Interpolation
+   {
+      InterpolationLinear,    // lerp of the stored values, as the colors are displayed
+      InterpolationSRGB,      // stored values are sRGB encoded, lerp is done in linear light
+      InterpolationOKLab      // perceptual, lerp in OKLab
+   };
+
+   // stops are colors with their position in w, sorted on w. Output colors use the stops encoding, with alpha 1.
+   // t values are sorted in ascending order, evaluated in one pass over the stops
+   void Sample(const ImVec4* stops, size_t stopCount, const float* t, ImVec4* colors, size_t count, Interpolation interpolation = InterpolationLinear);
+
+   // bake resolution evenly spaced colors over [0, 1], as RGBA floats or RGBA bytes, ready for a texture upload
+   void BakeRGBA32F(const ImVec4* stops, size_t stopCount, float* rgba, size_t resolution, Interpolation interpolation = InterpolationLinear);
+   void BakeRGBA8(const ImVec4* stops, size_t stopCount, unsigned char* rgba, size_t resolution, Interpolation interpolation = InterpolationLinear);
+}
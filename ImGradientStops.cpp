@@ -0,0 +1,91 @@
+#include "ImGradientStops.h"
+#include "imgui_internal.h"
+
+namespace ImGradient
+{
+   int GradientStops::FindInterval(float t) const
+   {
+      int first = 0;
+      int count = stops.Size;
+      while (count > 0)
+      {
+         const int step = count / 2;
+         if (stops[first + step].w <= t)
+         {
+            first += step + 1;
+            count -= step + 1;
+         }
+         else
+         {
+            count = step;
+         }
+      }
+      return first;
+   }
+
+   int GradientStops::Insert(const ImVec4& value)
+   {
+      const int index = FindInterval(value.w);
+      stops.insert(stops.Data + index, value);
+      return index;
+   }
+
+   int GradientStops::EditPoint(int pointIndex, ImVec4 value)
+   {
+      version++;
+      value.w = ImSaturate(value.w);
+      // moves only shift the stops between the old and new position
+      int index = pointIndex;
+      while (index > 0 && stops[index - 1].w > value.w)
+      {
+         stops[index] = stops[index - 1];
+         index--;
+      }
+      while (index < stops.Size - 1 && stops[index + 1].w < value.w)
+      {
+         stops[index] = stops[index + 1];
+         index++;
+      }
+      stops[index] = value;
+      return index;
+   }
+
+   ImVec4 GradientStops::GetPoint(float t)
+   {
+      ImVec4 color;
+      if (stops.Size < 2)
+      {
+         Sample(stops.Data, size_t(stops.Size), &t, &color, 1, interpolation);
+      }
+      else
+      {
+         // sample the segment around t only
+         const int segment = ImClamp(FindInterval(t), 1, stops.Size - 1);
+         Sample(stops.Data + segment - 1, 2, &t, &color, 1, interpolation);
+      }
+      color.w = t;
+      return color;
+   }
+
+   void GradientStops::AddPoint(ImVec4 value)
+   {
+      version++;
+      value.w = ImSaturate(value.w);
+      Insert(value);
+   }
+
+   void GradientStops::RemovePoint(int pointIndex)
+   {
+      version++;
+      stops.erase(stops.Data + pointIndex);
+   }
+
+   void GradientStops::SetPoints(const ImVec4* points, size_t count)
+   {
+      version++;
+      stops.resize(0);
+      stops.reserve(int(count));
+      for (size_t i = 0; i < count; i++)
+         Insert(points[i]);
+   }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "imgui.h"
+#include "ImGradient.h"
+#include "ImGradientSample.h"
+
+namespace ImGradient
+{
+   // ready-made Delegate keeping its stops sorted on position (w). Lookups are binary searches,
+   // and EditPoint returns the new index of a moved stop so Edit keeps it selected
+   struct GradientStops : public Delegate
+   {
+      Interpolation interpolation = InterpolationLinear;
+
+      virtual size_t GetPointCount() { return size_t(stops.Size); }
+      virtual ImVec4* GetPoints() { return stops.Data; }
+      virtual int EditPoint(int pointIndex, ImVec4 value);
+      virtual ImVec4 GetPoint(float t);
+      virtual void AddPoint(ImVec4 value);
+      virtual unsigned int GetVersion() { return version; }
+
+      void RemovePoint(int pointIndex);
+      void SetPoints(const ImVec4* points, size_t count);
+      // index of the first stop after t, in [0, count]
+      int FindInterval(float t) const;
+
+   private:
+      int Insert(const ImVec4& value);
+
+      ImVector<ImVec4> stops;
+      unsigned int version = 1;
+   };
+}
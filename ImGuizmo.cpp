@@ -26,6 +26,8 @@
 #endif
 #include "imgui_internal.h"
 #include "ImGuizmo.h"
+#include "ImGuizmoProfiler.h"
+#include "ImGuizmoState.h"
 
 // includes patches for multiview from
 // https://github.com/CedricGuillemet/ImGuizmo/issues/15
@@ -592,11 +594,17 @@ namespace ImGuizmo
    static const ImU32 selectionColor = 0x8A1080FF;
    static const ImU32 inactiveColor = 0x99999999;
    static const ImU32 translationLineColor = 0xAAAAAAAA;
+#ifndef IMGUIZMO_NO_TRANSLATE
    static const char *translationInfoMask[] = { "X : %5.3f", "Y : %5.3f", "Z : %5.3f",
       "Y : %5.3f Z : %5.3f", "X : %5.3f Z : %5.3f", "X : %5.3f Y : %5.3f",
       "X : %5.3f Y : %5.3f Z : %5.3f" };
+#endif
+#ifndef IMGUIZMO_NO_SCALE
    static const char *scaleInfoMask[] = { "X : %5.2f", "Y : %5.2f", "Z : %5.2f", "XYZ : %5.2f" };
+#endif
+#ifndef IMGUIZMO_NO_ROTATE
    static const char *rotationInfoMask[] = { "X : %5.2f deg %5.2f rad", "Y : %5.2f deg %5.2f rad", "Z : %5.2f deg %5.2f rad", "Screen : %5.2f deg %5.2f rad" };
+#endif
    static const int translationInfoIndex[] = { 0,0,0, 1,0,0, 2,0,0, 1,2,0, 0,2,0, 0,1,0, 0,1,2 };
    static const float quadMin = 0.5f;
    static const float quadMax = 0.8f;
@@ -783,6 +791,7 @@ namespace ImGuizmo
 
    static void ComputeContext(const float *view, const float *projection, float *matrix, MODE mode)
    {
+      IMGUIZMO_PROFILE_ZONE("ImGuizmo::ComputeContext");
       gContext.mMode = mode;
       gContext.mViewMat = *(matrix_t*)view;
       gContext.mProjectionMat = *(matrix_t*)projection;
@@ -927,6 +936,7 @@ namespace ImGuizmo
       else if (moduloRatio >(1.f - snapTension))
          *value = *value - modulo + snap * ((*value<0.f) ? -1.f : 1.f);
    }
+#if !defined(IMGUIZMO_NO_TRANSLATE) || !defined(IMGUIZMO_NO_SCALE)
    static void ComputeSnap(vec_t& value, float *snap)
    {
       for (int i = 0; i < 3; i++)
@@ -935,6 +945,9 @@ namespace ImGuizmo
       }
    }
 
+#endif
+
+#ifndef IMGUIZMO_NO_ROTATE
    static float ComputeAngleOnPlan()
    {
       const float len = IntersectRayPlane(gContext.mRayOrigin, gContext.mRayVector, gContext.mTranslationPlan);
@@ -951,6 +964,7 @@ namespace ImGuizmo
 
    static void DrawRotationGizmo(int type)
    {
+      IMGUIZMO_PROFILE_ZONE("ImGuizmo::DrawRotationGizmo");
       ImDrawList* drawList = gContext.mDrawList;
 
       // colors
@@ -1021,6 +1035,9 @@ namespace ImGuizmo
       }
    }
 
+#endif
+
+#if !defined(IMGUIZMO_NO_TRANSLATE) || !defined(IMGUIZMO_NO_SCALE)
    static void DrawHatchedAxis(const vec_t& axis)
    {
       for (int j = 1; j < 10; j++)
@@ -1031,8 +1048,12 @@ namespace ImGuizmo
       }
    }
 
+#endif
+
+#ifndef IMGUIZMO_NO_SCALE
    static void DrawScaleGizmo(int type)
    {
+      IMGUIZMO_PROFILE_ZONE("ImGuizmo::DrawScaleGizmo");
       ImDrawList* drawList = gContext.mDrawList;
 
       // colors
@@ -1096,8 +1117,12 @@ namespace ImGuizmo
    }
 
 
+#endif
+
+#ifndef IMGUIZMO_NO_TRANSLATE
    static void DrawTranslationGizmo(int type)
    {
+      IMGUIZMO_PROFILE_ZONE("ImGuizmo::DrawTranslationGizmo");
       ImDrawList* drawList = gContext.mDrawList;
       if (!drawList)
           return;
@@ -1176,6 +1201,8 @@ namespace ImGuizmo
       }
    }
 
+#endif
+
    static bool CanActivate()
    {
       if (ImGui::IsMouseClicked(0) && !ImGui::IsAnyItemHovered() && !ImGui::IsAnyItemActive())
@@ -1183,8 +1210,10 @@ namespace ImGuizmo
       return false;
    }
 
+#ifndef IMGUIZMO_NO_BOUNDS
    static void HandleAndDrawLocalBounds(float *bounds, matrix_t *matrix, float *snapValues, OPERATION operation)
    {
+       IMGUIZMO_PROFILE_ZONE("ImGuizmo::HandleAndDrawLocalBounds");
        ImGuiIO& io = ImGui::GetIO();
        ImDrawList* drawList = gContext.mDrawList;
 
@@ -1428,8 +1457,14 @@ namespace ImGuizmo
    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
    //
 
+#endif
+
+#ifdef IMGUIZMO_NO_SCALE
+   static int GetScaleType() { return NONE; }
+#else
    static int GetScaleType()
    {
+      IMGUIZMO_PROFILE_ZONE("ImGuizmo::GetScaleType");
       ImGuiIO& io = ImGui::GetIO();
       int type = NONE;
 
@@ -1460,8 +1495,14 @@ namespace ImGuizmo
       return type;
    }
 
+#endif
+
+#ifdef IMGUIZMO_NO_ROTATE
+   static int GetRotateType() { return NONE; }
+#else
    static int GetRotateType()
    {
+      IMGUIZMO_PROFILE_ZONE("ImGuizmo::GetRotateType");
       ImGuiIO& io = ImGui::GetIO();
       int type = NONE;
 
@@ -1497,8 +1538,14 @@ namespace ImGuizmo
       return type;
    }
 
+#endif
+
+#ifdef IMGUIZMO_NO_TRANSLATE
+   static int GetMoveType(vec_t *) { return NONE; }
+#else
    static int GetMoveType(vec_t *gizmoHitProportion)
    {
+      IMGUIZMO_PROFILE_ZONE("ImGuizmo::GetMoveType");
       ImGuiIO& io = ImGui::GetIO();
       int type = NONE;
 
@@ -1639,6 +1686,9 @@ namespace ImGuizmo
       }
    }
 
+#endif
+
+#ifndef IMGUIZMO_NO_SCALE
    static void HandleScale(float *matrix, float *deltaMatrix, int& type, float *snap)
    {
       ImGuiIO& io = ImGui::GetIO();
@@ -1727,6 +1777,9 @@ namespace ImGuizmo
       }
    }
 
+#endif
+
+#ifndef IMGUIZMO_NO_ROTATE
    static void HandleRotation(float *matrix, float *deltaMatrix, int& type, float *snap)
    {
       ImGuiIO& io = ImGui::GetIO();
@@ -1815,6 +1868,8 @@ namespace ImGuizmo
       }
    }
 
+#endif
+
    void DecomposeMatrixToComponents(const float *matrix, float *translation, float *rotation, float *scale)
    {
       matrix_t mat = *(matrix_t*)matrix;
@@ -1858,7 +1913,8 @@ namespace ImGuizmo
       mat.v.position.Set(translation[0], translation[1], translation[2], 1.f);
    }
 
-   void Manipulate(const float *view, const float *projection, OPERATION operation, MODE mode, float *matrix, float *deltaMatrix, float *snap, float *localBounds, float *boundsSnap)
+   // returns the hovered or manipulated part of the gizmo
+   static int ManipulateGizmo(const float *view, const float *projection, OPERATION operation, MODE mode, float *matrix, float *deltaMatrix, float *snap, float *localBounds, float *boundsSnap)
    {
       ComputeContext(view, projection, matrix, mode);
 
@@ -1870,7 +1926,7 @@ namespace ImGuizmo
       vec_t camSpacePosition;
       camSpacePosition.TransformPoint(makeVect(0.f, 0.f, 0.f), gContext.mMVP);
       if (!gContext.mIsOrthographic && camSpacePosition.z < 0.001f)
-         return;
+         return NONE;
 
       // --
       int type = NONE;
@@ -1880,41 +1936,158 @@ namespace ImGuizmo
           {
               switch (operation)
               {
+#ifndef IMGUIZMO_NO_ROTATE
               case ROTATE:
                   HandleRotation(matrix, deltaMatrix, type, snap);
                   break;
+#endif
+#ifndef IMGUIZMO_NO_TRANSLATE
               case TRANSLATE:
                   HandleTranslation(matrix, deltaMatrix, type, snap);
                   break;
+#endif
+#ifndef IMGUIZMO_NO_SCALE
               case SCALE:
                   HandleScale(matrix, deltaMatrix, type, snap);
                   break;
-              case BOUNDS:
+#endif
+              default:
                   break;
               }
           }
       }
 
+#ifndef IMGUIZMO_NO_BOUNDS
       if (localBounds && !gContext.mbUsing)
           HandleAndDrawLocalBounds(localBounds, (matrix_t*)matrix, boundsSnap, operation);
+#else
+      (void)localBounds;
+      (void)boundsSnap;
+#endif
 
       if (!gContext.mbUsingBounds)
       {
           switch (operation)
           {
+#ifndef IMGUIZMO_NO_ROTATE
           case ROTATE:
               DrawRotationGizmo(type);
               break;
+#endif
+#ifndef IMGUIZMO_NO_TRANSLATE
           case TRANSLATE:
               DrawTranslationGizmo(type);
               break;
+#endif
+#ifndef IMGUIZMO_NO_SCALE
           case SCALE:
               DrawScaleGizmo(type);
               break;
-          case BOUNDS:
+#endif
+          default:
               break;
           }
       }
+      return type;
+   }
+
+   // geometry and context of the last Manipulate call for a matrix, replayed while its inputs don't change
+   struct RetainedGizmo
+   {
+      ImU32 inputHash = 0;
+      bool valid = false;
+      bool hovered = false;
+      Context context;
+      ImRetainedGeometry geometry;
+   };
+
+   struct RetainedMode
+   {
+      bool enabled = false;
+      unsigned int hits = 0;
+      unsigned int misses = 0;
+      ImWidgetStates<RetainedGizmo> gizmos; // keyed by the matrix pointer
+   };
+
+   static RetainedMode gRetained;
+
+   void SetRetained(bool retained)
+   {
+      gRetained.enabled = retained;
+   }
+
+   void GetRetainedStats(unsigned int *hits, unsigned int *misses)
+   {
+      if (hits)
+         *hits = gRetained.hits;
+      if (misses)
+         *misses = gRetained.misses;
+   }
+
+   void ResetRetainedStats()
+   {
+      gRetained.hits = 0;
+      gRetained.misses = 0;
+   }
+
+   void ClearRetained()
+   {
+      gRetained.gizmos.Clear();
+   }
+
+   // everything the drawing and the hover test depend on when the gizmo is not in use
+   static ImU32 HashManipulateInputs(const float *view, const float *projection, OPERATION operation, MODE mode, const float *matrix, const float *localBounds)
+   {
+      ImGuiIO& io = ImGui::GetIO();
+      ImU32 hash = ImHashData(view, sizeof(float) * 16, 0);
+      hash = ImHashData(projection, sizeof(float) * 16, hash);
+      hash = ImHashData(matrix, sizeof(float) * 16, hash);
+      if (localBounds)
+         hash = ImHashData(localBounds, sizeof(float) * 6, hash);
+      const float frame[] = { io.MousePos.x, io.MousePos.y, gContext.mX, gContext.mY, gContext.mWidth, gContext.mHeight };
+      hash = ImHashData(frame, sizeof(frame), hash);
+      // CanActivate and the hover test give way to other items under the mouse
+      const int state[] = { int(operation), int(mode), localBounds != NULL, io.MouseDown[0], io.MouseClicked[0], gContext.mbEnable, gContext.mIsOrthographic,
+         ImGui::IsAnyItemHovered(), ImGui::IsAnyItemActive() };
+      hash = ImHashData(state, sizeof(state), hash);
+      return ImHashData(&gContext.mDrawList, sizeof(gContext.mDrawList), hash);
+   }
+
+   void Manipulate(const float *view, const float *projection, OPERATION operation, MODE mode, float *matrix, float *deltaMatrix, float *snap, float *localBounds, float *boundsSnap)
+   {
+      IMGUIZMO_PROFILE_ZONE("ImGuizmo::Manipulate");
+      if (!gRetained.enabled || gContext.mbUsing || gContext.mbUsingBounds)
+      {
+         ManipulateGizmo(view, projection, operation, mode, matrix, deltaMatrix, snap, localBounds, boundsSnap);
+         return;
+      }
+
+      RetainedGizmo& retained = gRetained.gizmos.Get(ImHashData(&matrix, sizeof(matrix), 0));
+      const ImU32 inputHash = HashManipulateInputs(view, projection, operation, mode, matrix, localBounds);
+      if (retained.valid && retained.inputHash == inputHash)
+      {
+         gRetained.hits++;
+         if (deltaMatrix)
+            ((matrix_t*)deltaMatrix)->SetToIdentity();
+         gContext = retained.context;
+         if (retained.hovered)
+            ImGui::CaptureMouseFromApp();
+         retained.geometry.Emit(gContext.mDrawList);
+         return;
+      }
+      gRetained.misses++;
+
+      ImDrawList* drawList = gContext.mDrawList;
+      retained.geometry.Begin(drawList);
+      const int type = ManipulateGizmo(view, projection, operation, mode, matrix, deltaMatrix, snap, localBounds, boundsSnap);
+
+      // nothing to replay once the gizmo is grabbed, or when the draw list started a new command in between
+      retained.valid = retained.geometry.End(drawList) && !gContext.mbUsing && !gContext.mbUsingBounds;
+      if (!retained.valid)
+         return;
+      retained.inputHash = inputHash;
+      retained.hovered = type != NONE;
+      retained.context = gContext;
    }
 
    void DrawCube(const float *view, const float *projection, const float *matrix)
@@ -170,4 +170,14 @@ namespace ImGuizmo
 	};
 
 	IMGUI_API void Manipulate(const float *view, const float *projection, OPERATION operation, MODE mode, float *matrix, float *deltaMatrix = 0, float *snap = 0, float *localBounds = NULL, float *boundsSnap = NULL);
+
+	// retained mode, off by default. While the gizmo is not in use and view, projection, matrix, operation, mode, bounds,
+	// rect, mouse and hovered/active ImGui items are the same as in the previous Manipulate call for that matrix pointer, the geometry of that call
+	// is copied to the draw list again instead of being recomputed.
+	IMGUI_API void SetRetained(bool retained);
+	// number of Manipulate calls that reused (hits) or recomputed (misses) the gizmo in retained mode since the last reset
+	IMGUI_API void GetRetainedStats(unsigned int *hits, unsigned int *misses);
+	IMGUI_API void ResetRetainedStats();
+	// frees the geometry retained for every matrix, e.g. before destroying the ImGui context
+	IMGUI_API void ClearRetained();
 };
@@ -0,0 +1,83 @@
+#include "ImGuizmoProfiler.h"
+
+#if defined(IMGUIZMO_PROFILE_BUILTIN)
+#include <chrono>
+#include <string.h>
+
+namespace ImGuizmoProfiler
+{
+   static const int MaxZones = 128;
+   static ZoneStats zones[MaxZones];
+   static int zoneCount = 0;
+
+   static long long Now()
+   {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+   }
+
+   // few zones, names are literals so the pointer compare nearly always hits first
+   static int FindZone(const char* name)
+   {
+      for (int i = 0; i < zoneCount; i++)
+      {
+         if (zones[i].name == name || !strcmp(zones[i].name, name))
+            return i;
+      }
+      if (zoneCount == MaxZones)
+         return -1;
+      ZoneStats& zone = zones[zoneCount];
+      zone.name = name;
+      zone.count = 0;
+      zone.totalMs = 0.0;
+      zone.maxMs = 0.0;
+      return zoneCount++;
+   }
+
+   Zone::Zone(const char* name) : index(FindZone(name)), start(Now())
+   {
+   }
+
+   Zone::~Zone()
+   {
+      if (index < 0)
+         return;
+      const double ms = double(Now() - start) * 1e-6;
+      ZoneStats& zone = zones[index];
+      zone.count++;
+      zone.totalMs += ms;
+      if (ms > zone.maxMs)
+         zone.maxMs = ms;
+   }
+
+   int GetZoneCount()
+   {
+      return zoneCount;
+   }
+
+   const ZoneStats& GetZone(int index)
+   {
+      return zones[index];
+   }
+
+   // zones are kept, in-flight Zone objects refer to them by index
+   void Reset()
+   {
+      for (int i = 0; i < zoneCount; i++)
+      {
+         zones[i].count = 0;
+         zones[i].totalMs = 0.0;
+         zones[i].maxMs = 0.0;
+      }
+   }
+
+   void Dump(FILE* file)
+   {
+      fprintf(file, "%-40s %10s %12s %10s %10s\n", "zone", "count", "total ms", "mean ms", "max ms");
+      for (int i = 0; i < zoneCount; i++)
+      {
+         const ZoneStats& zone = zones[i];
+         fprintf(file, "%-40s %10llu %12.3f %10.4f %10.4f\n", zone.name, zone.count, zone.totalMs, zone.count ? zone.totalMs / double(zone.count) : 0.0, zone.maxMs);
+      }
+   }
+}
+#endif
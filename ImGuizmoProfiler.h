@@ -0,0 +1,52 @@
+#pragma once
+#include <stdio.h>
+
+// IMGUIZMO_PROFILE_ZONE(name) times the enclosing scope. Zones are compiled out unless IMGUIZMO_PROFILE is defined,
+// in which case they are aggregated in an in-memory table by the default implementation below.
+// To route zones to another profiler, define IMGUIZMO_USER_CONFIG to a header of yours (e.g. -DIMGUIZMO_USER_CONFIG="\"my_profiler.h\"")
+// that includes the profiler and defines IMGUIZMO_PROFILE_ZONE, e.g. #define IMGUIZMO_PROFILE_ZONE(name) ZoneScopedN(name)
+#ifdef IMGUIZMO_USER_CONFIG
+#include IMGUIZMO_USER_CONFIG
+#endif
+
+#if defined(IMGUIZMO_PROFILE) && !defined(IMGUIZMO_PROFILE_ZONE)
+// set when the zones use the default implementation, ImGuizmoProfiler.cpp is empty otherwise
+#define IMGUIZMO_PROFILE_BUILTIN
+
+namespace ImGuizmoProfiler
+{
+   struct ZoneStats
+   {
+      const char* name;
+      unsigned long long count;
+      double totalMs;
+      double maxMs;
+   };
+
+   // zone names are expected to be string literals
+   struct Zone
+   {
+      Zone(const char* name);
+      ~Zone();
+
+   private:
+      int index;
+      long long start;
+   };
+
+   int GetZoneCount();
+   const ZoneStats& GetZone(int index);
+   void Reset();
+   // one line per zone: name, count, total, mean and max time
+   void Dump(FILE* file = stdout);
+}
+
+#define IMGUIZMO_PROFILE_CONCAT_(a, b) a##b
+#define IMGUIZMO_PROFILE_CONCAT(a, b) IMGUIZMO_PROFILE_CONCAT_(a, b)
+#define IMGUIZMO_PROFILE_ZONE(name) ImGuizmoProfiler::Zone IMGUIZMO_PROFILE_CONCAT(profileZone, __LINE__)(name)
+
+#endif
+
+#ifndef IMGUIZMO_PROFILE_ZONE
+#define IMGUIZMO_PROFILE_ZONE(name)
+#endif
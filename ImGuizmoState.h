@@ -0,0 +1,106 @@
+#pragma once
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <string.h>
+
+// state kept across frames by the widgets, one object per ImGui context and widget id.
+// Objects are created on first use and live until Clear, so contexts never share a state.
+template<typename T> struct ImWidgetStates
+{
+   ~ImWidgetStates() { Clear(); }
+
+   T& Get(ImGuiID id)
+   {
+      const ImGuiID key = GetKey(id);
+      T* state = (T*)states.GetVoidPtr(key);
+      if (!state)
+      {
+         state = new T;
+         states.SetVoidPtr(key, state);
+      }
+      return *state;
+   }
+
+   // NULL when the widget was not drawn yet
+   T* Find(ImGuiID id) const
+   {
+      return (T*)states.GetVoidPtr(GetKey(id));
+   }
+
+   // frees the states of every context
+   void Clear()
+   {
+      for (int i = 0; i < states.Data.Size; i++)
+         delete (T*)states.Data[i].val_p;
+      states.Clear();
+   }
+
+private:
+   static ImGuiID GetKey(ImGuiID id)
+   {
+      const ImGuiContext* context = ImGui::GetCurrentContext();
+      return ImHashData(&context, sizeof(context), id);
+   }
+
+   ImGuiStorage states;
+};
+
+// draw list geometry recorded once and copied back to a draw list on later frames
+struct ImRetainedGeometry
+{
+   ImVector<ImDrawVert> vertices;
+   ImVector<ImDrawIdx> indices; // relative to the first vertex
+
+   // mark the draw list before drawing the geometry
+   void Begin(const ImDrawList* draw_list)
+   {
+      vtxStart = draw_list->VtxBuffer.Size;
+      idxStart = draw_list->IdxBuffer.Size;
+      vtxIndexStart = draw_list->_VtxCurrentIdx;
+   }
+
+   // copy what was drawn since Begin. Returns false, leaving the geometry empty, when the draw list
+   // started a new command in between: indices can't be rebased then
+   bool End(const ImDrawList* draw_list)
+   {
+      const int vtxCount = draw_list->VtxBuffer.Size - vtxStart;
+      const int idxCount = draw_list->IdxBuffer.Size - idxStart;
+      if (draw_list->_VtxCurrentIdx != vtxIndexStart + unsigned(vtxCount))
+      {
+         vertices.resize(0);
+         indices.resize(0);
+         return false;
+      }
+      vertices.resize(vtxCount);
+      indices.resize(idxCount);
+      if (vtxCount)
+         memcpy(vertices.Data, draw_list->VtxBuffer.Data + vtxStart, vtxCount * sizeof(ImDrawVert));
+      for (int i = 0; i < idxCount; i++)
+         indices[i] = ImDrawIdx(draw_list->IdxBuffer[idxStart + i] - vtxIndexStart);
+      return true;
+   }
+
+   void Emit(ImDrawList* draw_list) const
+   {
+      if (vertices.empty())
+         return;
+      draw_list->PrimReserve(indices.Size, vertices.Size);
+      const unsigned int firstIndex = draw_list->_VtxCurrentIdx;
+      memcpy(draw_list->_VtxWritePtr, vertices.Data, vertices.Size * sizeof(ImDrawVert));
+      for (int i = 0; i < indices.Size; i++)
+         draw_list->_IdxWritePtr[i] = ImDrawIdx(firstIndex + indices[i]);
+      draw_list->_VtxWritePtr += vertices.Size;
+      draw_list->_IdxWritePtr += indices.Size;
+      draw_list->_VtxCurrentIdx += vertices.Size;
+   }
+
+   size_t GetCapacity() const
+   {
+      return vertices.capacity() * sizeof(ImDrawVert) + indices.capacity() * sizeof(ImDrawIdx);
+   }
+
+private:
+   int vtxStart = 0;
+   int idxStart = 0;
+   unsigned int vtxIndexStart = 0;
+};
@@ -0,0 +1,41 @@
+// Single translation unit build of the library. Build this file instead of the others (IMGUIZMO_UNITY_BUILD with cmake),
+// or include it in one translation unit of the application so the gizmo math can be inlined there.
+// When included, it must come before any imgui header of that translation unit: the widgets use the imgui math operators,
+// only declared when IMGUI_DEFINE_MATH_OPERATORS is defined before imgui is first included. Defining
+// IMGUI_DEFINE_MATH_OPERATORS for the whole translation unit works as well.
+//
+// Widgets left out of the build:
+//    IMGUIZMO_NO_GIZMO, IMGUIZMO_NO_SEQUENCER, IMGUIZMO_NO_CURVE_EDIT, IMGUIZMO_NO_GRADIENT
+// Gizmo operations left out of Manipulate (also honored by the regular build of ImGuizmo.cpp):
+//    IMGUIZMO_NO_TRANSLATE, IMGUIZMO_NO_ROTATE, IMGUIZMO_NO_SCALE, IMGUIZMO_NO_BOUNDS
+
+// every file shares imgui math operators instead of defining its own
+#ifndef IMGUI_DEFINE_MATH_OPERATORS
+#ifdef IMGUI_VERSION
+#error "imgui was included without IMGUI_DEFINE_MATH_OPERATORS: include ImGuizmoUnity.cpp first, or define IMGUI_DEFINE_MATH_OPERATORS for the translation unit"
+#endif
+#define IMGUI_DEFINE_MATH_OPERATORS
+#endif
+
+#include "ImGuizmoProfiler.cpp"
+
+#ifndef IMGUIZMO_NO_GIZMO
+#include "ImGuizmo.cpp"
+#endif
+
+#ifndef IMGUIZMO_NO_SEQUENCER
+#include "ImSequencer.cpp"
+#include "ImSequencerWaveform.cpp"
+#include "ImSequencerPlayback.cpp"
+#endif
+
+#ifndef IMGUIZMO_NO_CURVE_EDIT
+#include "ImCurveEdit.cpp"
+#include "ImCurveSample.cpp"
+#endif
+
+#ifndef IMGUIZMO_NO_GRADIENT
+#include "ImGradient.cpp"
+#include "ImGradientSample.cpp"
+#include "ImGradientStops.cpp"
+#endif
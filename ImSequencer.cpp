@@ -1,7 +1,10 @@
 #include "ImSequencer.h"
+#include "ImGuizmoProfiler.h"
+#include "ImGuizmoState.h"
 #include "imgui.h"
 #include "imgui_internal.h"
 #include <cstdlib>
+#include <stdint.h>
 
 namespace ImSequencer
 {
@@ -28,19 +31,274 @@ namespace ImSequencer
     static int min(int a, int b) { return (a < b) ? a : b; }
     static int max(int a, int b) { return (a > b) ? a : b; }
 
-    bool Sequencer(SequenceInterface *sequence, int *currentFrame, bool *expanded, int *selectedEntry, int *firstFrame, int sequenceOptions)
+    template<typename T> static T* SpanElement(T* base, size_t stride, int index)
     {
+        return (T*)((const char*)base + stride * size_t(index));
+    }
+
+    static int ClipCount(SequenceInterface* sequence, const ItemSpans* spans, int index)
+    {
+        return spans ? 1 : sequence->GetClipCount(index);
+    }
+
+    static void FetchClip(SequenceInterface* sequence, const ItemSpans* spans, int index, int clip, int** start, int** end, unsigned int* color)
+    {
+        if (!spans)
+        {
+            sequence->GetClip(index, clip, start, end, color);
+            return;
+        }
+        if (start)
+            *start = SpanElement(spans->start, spans->stride, index);
+        if (end)
+            *end = SpanElement(spans->end, spans->stride, index);
+        if (color)
+            *color = *SpanElement(spans->color, spans->stride, index);
+    }
+
+    // clips of an item overlapping [firstFrame, lastFrame]. Clips are sorted and don't overlap so both ends
+    // are binary searches. lastClip < firstClip when there is none
+    static void FindClips(SequenceInterface* sequence, const ItemSpans* spans, int index, int firstFrame, int lastFrame, int& firstClip, int& lastClip)
+    {
+        const int clipCount = ClipCount(sequence, spans, index);
+        // first clip ending at or after firstFrame
+        int first = 0;
+        int count = clipCount;
+        while (count > 0)
+        {
+            const int step = count / 2;
+            int *end;
+            FetchClip(sequence, spans, index, first + step, NULL, &end, NULL);
+            if (*end < firstFrame)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+        firstClip = first;
+        // first clip starting after lastFrame
+        count = clipCount - first;
+        while (count > 0)
+        {
+            const int step = count / 2;
+            int *start;
+            FetchClip(sequence, spans, index, first + step, &start, NULL, NULL);
+            if (*start <= lastFrame)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+        lastClip = first - 1;
+    }
+
+    // multi selection is a sorted list of clips
+    static int SelectionLowerBound(const ImVector<ClipIndex>& selection, const ClipIndex& clip)
+    {
+        int first = 0;
+        int count = selection.Size;
+        while (count > 0)
+        {
+            const int step = count / 2;
+            if (selection[first + step] < clip)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+        return first;
+    }
+
+    static bool IsSelected(const ImVector<ClipIndex>& selection, const ClipIndex& clip)
+    {
+        const int position = SelectionLowerBound(selection, clip);
+        return position < selection.Size && !(clip < selection[position]);
+    }
+
+    static void ToggleSelection(ImVector<ClipIndex>& selection, const ClipIndex& clip)
+    {
+        const int position = SelectionLowerBound(selection, clip);
+        if (position < selection.Size && !(clip < selection[position]))
+            selection.erase(selection.Data + position);
+        else
+            selection.insert(selection.Data + position, clip);
+    }
+
+    // integer to ascii, at least minDigits digits. Returns the end of the written text
+    static char* WriteInt(char* dest, int value, int minDigits = 1)
+    {
+        unsigned int magnitude = value < 0 ? 0u - unsigned(value) : unsigned(value);
+        if (value < 0)
+            *dest++ = '-';
+        char digits[10];
+        int digitCount = 0;
+        do
+        {
+            digits[digitCount++] = char('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude);
+        for (; digitCount < minDigits; minDigits--)
+            *dest++ = '0';
+        while (digitCount)
+            *dest++ = digits[--digitCount];
+        *dest = 0;
+        return dest;
+    }
+
+    // frame number, or SMPTE hh:mm:ss:ff when frameRate > 0
+    static void FormatFrame(char* dest, int frame, int frameRate)
+    {
+        if (frameRate <= 0)
+        {
+            WriteInt(dest, frame);
+            return;
+        }
+        unsigned int frames = frame < 0 ? 0u - unsigned(frame) : unsigned(frame);
+        if (frame < 0)
+            *dest++ = '-';
+        const unsigned int seconds = frames / unsigned(frameRate);
+        dest = WriteInt(dest, int(seconds / 3600), 2);
+        *dest++ = ':';
+        dest = WriteInt(dest, int((seconds / 60) % 60), 2);
+        *dest++ = ':';
+        dest = WriteInt(dest, int(seconds % 60), 2);
+        *dest++ = ':';
+        WriteInt(dest, int(frames % unsigned(frameRate)), 2);
+    }
+
+    // ruler and cursor labels, formatted once and reused across frames
+    struct LabelCache
+    {
+        int frameRate = 0;
+        ImGuiStorage offsets;
+        ImVector<char> text;
+
+        const char* Get(int frame, int newFrameRate)
+        {
+            // bounded: a long scrub through a long timeline restarts the cache
+            if (newFrameRate != frameRate || text.Size > 64 * 1024)
+            {
+                frameRate = newFrameRate;
+                offsets.Clear();
+                text.resize(0);
+            }
+            const ImGuiID key = ImGuiID(frame);
+            int offset = offsets.GetInt(key, -1);
+            if (offset < 0)
+            {
+                char label[32];
+                FormatFrame(label, frame, frameRate);
+                offset = text.Size;
+                for (const char* c = label; *c; c++)
+                    text.push_back(*c);
+                text.push_back(0);
+                offsets.SetInt(key, offset);
+            }
+            return text.Data + offset;
+        }
+    };
+
+    struct CustomDraw
+    {
+        int index;
+        ImRect customRect;
+        ImRect legendRect;
+        ImRect clippingRect;
+        ImRect legendClippingRect;
+    };
+
+    // zoom, drag and selection state of one sequencer widget
+    struct SequencerState
+    {
+        float framePixelWidth = 10.f;
+        float framePixelWidthTarget = 10.f;
+        int movingEntry = -1;
+        int movingPos = -1;
+        int movingPart = -1;
+        int movingClip = 0;
+        bool movedEntries = false;
+        ImVector<ClipIndex> selection;
+        bool selectingBand = false;
+        ImVec2 bandOrigin;
+        LabelCache labels;
+        ImVector<int> rowOffsets;
+        unsigned int rowOffsetsVersion = 0;
+        bool MovingScrollBar = false;
+        bool MovingCurrentFrame = false;
+        bool panningView = false;
+        ImVec2 panningViewSource;
+        int panningViewFrame = 0;
+        bool sizingRBar = false;
+        bool sizingLBar = false;
+        // kept across frames so recording custom draws doesn't allocate
+        ImVector<CustomDraw> customDraws;
+        ImVector<CustomDraw> compactCustomDraws;
+    };
+
+    // one state per widget ID so several sequencers can be drawn in the same frame
+    static ImWidgetStates<SequencerState> sequencerStates;
+
+    void ClearState()
+    {
+        sequencerStates.Clear();
+    }
+
+    // row containing the y offset, rowOffsets being the prefix sum of row heights
+    static int FindRow(const ImVector<int>& rowOffsets, int y)
+    {
+        int first = 0;
+        int count = rowOffsets.Size - 2;
+        while (count > 0)
+        {
+            const int step = count / 2;
+            if (rowOffsets[first + step + 1] <= y)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+        return first;
+    }
+
+    bool Sequencer(SequenceInterface *sequence, int *currentFrame, bool *expanded, int *selectedEntry, int *firstFrame, int sequenceOptions, ImVector<ClipIndex> *selectedClips)
+    {
+        IMGUIZMO_PROFILE_ZONE("ImSequencer::Sequencer");
         bool ret = false;
         ImGuiIO& io = ImGui::GetIO();
         int cx = (int)(io.MousePos.x);
         int cy = (int)(io.MousePos.y);
-        static float framePixelWidth = 10.f;
-        static float framePixelWidthTarget = 10.f;
+        const ImGuiID id = ImGui::GetID(sequence);
+        SequencerState& state = sequencerStates.Get(id);
+        float& framePixelWidth = state.framePixelWidth;
+        float& framePixelWidthTarget = state.framePixelWidthTarget;
         int legendWidth = 200;
 
-        static int movingEntry = -1;
-        static int movingPos = -1;
-        static int movingPart = -1;
+        int& movingEntry = state.movingEntry;
+        int& movingPos = state.movingPos;
+        int& movingPart = state.movingPart;
+        int& movingClip = state.movingClip;
+        bool& movedEntries = state.movedEntries;
+        ImVector<ClipIndex>& selection = state.selection;
+        bool& selectingBand = state.selectingBand;
+        ImVec2& bandOrigin = state.bandOrigin;
+        LabelCache& labels = state.labels;
+        const int frameRate = sequence->GetFrameRate();
         int delEntry = -1;
         int dupEntry = -1;
         int ItemHeight = 20;
@@ -49,6 +307,8 @@ namespace ImSequencer
         int sequenceCount = sequence->GetItemCount();
         if (!sequenceCount)
             return false;
+        ItemSpans itemSpans;
+        const ItemSpans* spans = sequence->GetSpans(itemSpans) ? &itemSpans : NULL;
         ImGui::BeginGroup();
         
         ImDrawList* draw_list = ImGui::GetWindowDrawList();
@@ -58,23 +318,29 @@ namespace ImSequencer
         int firstFrameUsed = firstFrame ? *firstFrame : 0;
 
 
-        int controlHeight = sequenceCount * ItemHeight;
-        for (int i = 0; i < sequenceCount; i++)
-            controlHeight += int(sequence->GetCustomHeight(i));
+        // y offset of each row from the top of the content, rowOffsets[sequenceCount] being the total height.
+        // only rebuilt when the layout version or the item count changes
+        ImVector<int>& rowOffsets = state.rowOffsets;
+        unsigned int& rowOffsetsVersion = state.rowOffsetsVersion;
+        const unsigned int layoutVersion = sequence->GetLayoutVersion();
+        if (!layoutVersion || layoutVersion != rowOffsetsVersion || rowOffsets.Size != sequenceCount + 1)
+        {
+            IMGUIZMO_PROFILE_ZONE("ImSequencer::RowOffsets");
+            rowOffsets.resize(sequenceCount + 1);
+            rowOffsets[0] = 0;
+            for (int i = 0; i < sequenceCount; i++)
+                rowOffsets[i + 1] = rowOffsets[i] + ItemHeight + int(sequence->GetCustomHeight(i));
+            rowOffsetsVersion = layoutVersion;
+        }
+        int controlHeight = rowOffsets[sequenceCount];
         int frameCount = ImMax(sequence->GetFrameMax() - sequence->GetFrameMin(), 1);
 
-        static bool MovingScrollBar = false;
-        static bool MovingCurrentFrame = false;
-        struct CustomDraw
-        {
-            int index;
-            ImRect customRect;
-            ImRect legendRect;
-            ImRect clippingRect;
-            ImRect legendClippingRect;
-        };
-        ImVector<CustomDraw> customDraws;
-        ImVector<CustomDraw> compactCustomDraws;
+        bool& MovingScrollBar = state.MovingScrollBar;
+        bool& MovingCurrentFrame = state.MovingCurrentFrame;
+        ImVector<CustomDraw>& customDraws = state.customDraws;
+        ImVector<CustomDraw>& compactCustomDraws = state.compactCustomDraws;
+        customDraws.resize(0);
+        compactCustomDraws.resize(0);
         // zoom in/out
         int frameOverCursor = 0;
         const int visibleFrameCount = (int)floorf((canvas_size.x - legendWidth) / framePixelWidth);
@@ -83,9 +349,9 @@ namespace ImSequencer
 
         ImRect regionRect(canvas_pos, canvas_pos + canvas_size);
         
-        static bool panningView = false;
-        static ImVec2 panningViewSource;
-        static int panningViewFrame;
+        bool& panningView = state.panningView;
+        ImVec2& panningViewSource = state.panningViewSource;
+        int& panningViewFrame = state.panningViewFrame;
         if (ImGui::IsWindowFocused() && io.KeyAlt && io.MouseDown[2])
         {
             if (!panningView)
@@ -101,7 +367,9 @@ namespace ImSequencer
         {
             panningView = false;
         }
-        framePixelWidthTarget = ImClamp(framePixelWidthTarget, 0.1f, 50.f);
+        // zooming out is bounded by the width showing the whole range, however long
+        const float fitFramePixelWidth = (canvas_size.x - legendWidth) / float(ImMax(sequence->GetFrameMax() - sequence->GetFrameMin(), 1));
+        framePixelWidthTarget = ImClamp(framePixelWidthTarget, ImMin(0.1f, fitFramePixelWidth), 50.f);
 
         framePixelWidth = ImLerp(framePixelWidth, framePixelWidthTarget, 0.33f);
 
@@ -137,7 +405,7 @@ namespace ImSequencer
             ImVec2 childFramePos = ImGui::GetCursorScreenPos();
             ImVec2 childFrameSize(canvas_size.x, canvas_size.y - 8.f - headerSize.y - (hasScrollBar ? scrollBarSize.y : 0));
             ImGui::PushStyleColor(ImGuiCol_FrameBg, 0);
-            ImGui::BeginChildFrame(889, childFrameSize);
+            ImGui::BeginChildFrame(id, childFrameSize);
             sequence->focused = ImGui::IsWindowFocused();
             ImGui::InvisibleButton("contentBar", ImVec2(canvas_size.x, float(controlHeight)));
             const ImVec2 contentMin = ImGui::GetItemRectMin();
@@ -145,6 +413,11 @@ namespace ImSequencer
             const ImRect contentRect(contentMin, contentMax);
             const float contentHeight = contentMax.y - contentMin.y;
 
+            // only rows intersecting the child frame are processed
+            const int firstVisibleRow = FindRow(rowOffsets, int(childFramePos.y - contentMin.y));
+            const int lastVisibleRow = FindRow(rowOffsets, int(childFramePos.y + childFrameSize.y - contentMin.y));
+            const int hoveredRow = (cy >= contentMin.y && cy < contentMin.y + controlHeight) ? FindRow(rowOffsets, cy - int(contentMin.y)) : -1;
+
             // full background
             draw_list->AddRectFilled(canvas_pos, canvas_pos + canvas_size, 0xFF242424, 0);
 
@@ -183,6 +456,8 @@ namespace ImSequencer
                         {
                             sequence->Add(i);
                             *selectedEntry = sequence->GetItemCount() - 1;
+                            // storage may have moved
+                            spans = sequence->GetSpans(itemSpans) ? &itemSpans : NULL;
                         }
 
                     ImGui::EndPopup();
@@ -193,7 +468,7 @@ namespace ImSequencer
             //header frame number and lines
             int modFrameCount = 10;
             int frameStep = 1;
-            while ((modFrameCount * framePixelWidth) < 150)
+            while ((modFrameCount * framePixelWidth) < 150 && modFrameCount < (1 << 29))
             {
                 modFrameCount *= 2;
                 frameStep *= 2;
@@ -203,7 +478,7 @@ namespace ImSequencer
             auto drawLine = [&](int i, int regionHeight) {
                 bool baseIndex = ((i % modFrameCount) == 0) || (i == sequence->GetFrameMax() || i == sequence->GetFrameMin());
                 bool halfIndex = (i % halfModFrameCount) == 0;
-                int px = (int)canvas_pos.x + int(i * framePixelWidth) + legendWidth - int(firstFrameUsed * framePixelWidth);
+                int px = (int)canvas_pos.x + int((i - firstFrameUsed) * framePixelWidth) + legendWidth;
                 int tiretStart = baseIndex ? 4 : (halfIndex ? 10 : 14);
                 int tiretEnd = baseIndex ? regionHeight : ItemHeight;
 
@@ -216,15 +491,13 @@ namespace ImSequencer
 
                 if (baseIndex && px > (canvas_pos.x + legendWidth))
                 {
-                    char tmps[512];
-                    sprintf(tmps, "%d", i);
-                    draw_list->AddText(ImVec2((float)px + 3.f, canvas_pos.y), 0xFFBBBBBB, tmps);
+                    draw_list->AddText(ImVec2((float)px + 3.f, canvas_pos.y), 0xFFBBBBBB, labels.Get(i, frameRate));
                 }
 
             };
 
             auto drawLineContent = [&](int i, int regionHeight) {
-                int px = (int)canvas_pos.x + int(i * framePixelWidth) + legendWidth - int(firstFrameUsed * framePixelWidth);
+                int px = (int)canvas_pos.x + int((i - firstFrameUsed) * framePixelWidth) + legendWidth;
                 int tiretStart = int(contentMin.y);
                 int tiretEnd = int(contentMax.y);
 
@@ -235,9 +508,12 @@ namespace ImSequencer
                     draw_list->AddLine(ImVec2(float(px), float(tiretStart)), ImVec2(float(px), float(tiretEnd)), 0x30606060, 1);
                 }
             };
-            for (int i = sequence->GetFrameMin(); i <= sequence->GetFrameMax(); i += frameStep)
+            // ticks are aligned on GetFrameMin, only the visible ones are walked
+            const int firstTick = sequence->GetFrameMin() + ImMax(firstFrameUsed - sequence->GetFrameMin(), 0) / frameStep * frameStep;
+            const int lastTick = int(ImMin(int64_t(firstFrameUsed) + visibleFrameCount + frameStep, int64_t(sequence->GetFrameMax())));
+            for (int64_t i = firstTick; i <= lastTick; i += frameStep)
             {
-                drawLine(i, ItemHeight);
+                drawLine(int(i), ItemHeight);
             }
             drawLine(sequence->GetFrameMin(), ItemHeight);
             drawLine(sequence->GetFrameMax(), ItemHeight);
@@ -250,151 +526,198 @@ namespace ImSequencer
             draw_list->PushClipRect(childFramePos, childFramePos + childFrameSize);
 
             // draw item names in the legend rect on the left
-            size_t customHeight = 0;
-            for (int i = 0; i < sequenceCount; i++)
             {
-                int type;
-                sequence->Get(i, NULL, NULL, &type, NULL);
-                ImVec2 tpos(contentMin.x + 3, contentMin.y + i * ItemHeight + 2 + customHeight);
-                draw_list->AddText(tpos, 0xFFFFFFFF, sequence->GetItemLabel(i));
-
-                if (sequenceOptions&SEQUENCER_DEL)
+                IMGUIZMO_PROFILE_ZONE("ImSequencer::Legend");
+                for (int i = firstVisibleRow; i <= lastVisibleRow; i++)
                 {
-                    bool overDel = SequencerAddDelButton(draw_list, ImVec2(contentMin.x + legendWidth - ItemHeight + 2 - 10, tpos.y + 2), false);
-                    if (overDel && io.MouseReleased[0])
-                        delEntry = i;
+                    ImVec2 tpos(contentMin.x + 3, contentMin.y + rowOffsets[i] + 2);
+                    draw_list->AddText(tpos, 0xFFFFFFFF, sequence->GetItemLabel(i));
 
-                    bool overDup = SequencerAddDelButton(draw_list, ImVec2(contentMin.x + legendWidth - ItemHeight - ItemHeight + 2 - 10, tpos.y + 2), true);
-                    if (overDup && io.MouseReleased[0])
-                        dupEntry = i;
+                    if (sequenceOptions&SEQUENCER_DEL)
+                    {
+                        bool overDel = SequencerAddDelButton(draw_list, ImVec2(contentMin.x + legendWidth - ItemHeight + 2 - 10, tpos.y + 2), false);
+                        if (overDel && io.MouseReleased[0])
+                            delEntry = i;
+
+                        bool overDup = SequencerAddDelButton(draw_list, ImVec2(contentMin.x + legendWidth - ItemHeight - ItemHeight + 2 - 10, tpos.y + 2), true);
+                        if (overDup && io.MouseReleased[0])
+                            dupEntry = i;
+                    }
                 }
-                customHeight += sequence->GetCustomHeight(i);
             }
 
             // clipping rect so items bars are not visible in the legend on the left when scrolled
             //
 
             // slots background
-            customHeight = 0;
-            for (int i = 0; i < sequenceCount; i++)
             {
-                unsigned int col = (i & 1) ? 0xFF3A3636 : 0xFF413D3D;
-
-                size_t localCustomHeight = sequence->GetCustomHeight(i);
-                ImVec2 pos = ImVec2(contentMin.x + legendWidth, contentMin.y + ItemHeight * i + 1 + customHeight);
-                ImVec2 sz = ImVec2(canvas_size.x + canvas_pos.x, pos.y + ItemHeight - 1 + localCustomHeight);
-                if (!popupOpened && cy >= pos.y && cy < pos.y + (ItemHeight + localCustomHeight) && movingEntry == -1 && cx>contentMin.x && cx < contentMin.x + canvas_size.x)
+                IMGUIZMO_PROFILE_ZONE("ImSequencer::RowBackgrounds");
+                for (int i = firstVisibleRow; i <= lastVisibleRow; i++)
                 {
-                    col += 0x80201008;
-                    pos.x -= legendWidth;
+                    unsigned int col = (i & 1) ? 0xFF3A3636 : 0xFF413D3D;
+
+                    size_t localCustomHeight = size_t(rowOffsets[i + 1] - rowOffsets[i] - ItemHeight);
+                    ImVec2 pos = ImVec2(contentMin.x + legendWidth, contentMin.y + rowOffsets[i] + 1);
+                    ImVec2 sz = ImVec2(canvas_size.x + canvas_pos.x, pos.y + ItemHeight - 1 + localCustomHeight);
+                    if (!popupOpened && i == hoveredRow && movingEntry == -1 && cx>contentMin.x && cx < contentMin.x + canvas_size.x)
+                    {
+                        col += 0x80201008;
+                        pos.x -= legendWidth;
+                    }
+                    draw_list->AddRectFilled(pos, sz, col, 0);
                 }
-                draw_list->AddRectFilled(pos, sz, col, 0);
-                customHeight += localCustomHeight;
             }
 
             draw_list->PushClipRect(childFramePos + ImVec2(float(legendWidth), 0.f), childFramePos + childFrameSize);
 
             // vertical frame lines in content area
-            for (int i = sequence->GetFrameMin(); i <= sequence->GetFrameMax(); i += frameStep)
+            for (int64_t i = firstTick; i <= lastTick; i += frameStep)
             {
-                drawLineContent(i, int(contentHeight));
+                drawLineContent(int(i), int(contentHeight));
             }
             drawLineContent(sequence->GetFrameMin(), int(contentHeight));
             drawLineContent(sequence->GetFrameMax(), int(contentHeight));
 
             // selection
             bool selected = selectedEntry && (*selectedEntry >= 0);
-            if (selected)
+            if (selected && *selectedEntry < sequenceCount)
             {
-                customHeight = 0;
-                for (int i = 0; i < *selectedEntry; i++)
-                    customHeight += sequence->GetCustomHeight(i);;
-                draw_list->AddRectFilled(ImVec2(contentMin.x, contentMin.y + ItemHeight * *selectedEntry + customHeight), ImVec2(contentMin.x + canvas_size.x, contentMin.y + ItemHeight * (*selectedEntry + 1) + customHeight), 0x801080FF, 1.f);
+                const float selectedY = contentMin.y + rowOffsets[*selectedEntry];
+                draw_list->AddRectFilled(ImVec2(contentMin.x, selectedY), ImVec2(contentMin.x + canvas_size.x, selectedY + ItemHeight), 0x801080FF, 1.f);
             }
 
             // slots
-            customHeight = 0;
-            for (int i = 0; i < sequenceCount; i++)
+            // positions are taken relative to firstFrameUsed to keep float precision on long timelines
+            const float framesX = contentMin.x + legendWidth;
+            const int lastVisibleFrame = firstFrameUsed + visibleFrameCount;
+            const ImRect visibleRect(childFramePos, childFramePos + childFrameSize);
             {
-                int *start, *end;
-                unsigned int color;
-                sequence->Get(i, &start, &end, NULL, &color);
-                size_t localCustomHeight = sequence->GetCustomHeight(i);
-
-                ImVec2 pos = ImVec2(contentMin.x + legendWidth - firstFrameUsed * framePixelWidth, contentMin.y + ItemHeight * i + 1 + customHeight);
-                ImVec2 slotP1(pos.x + *start * framePixelWidth, pos.y + 2);
-                ImVec2 slotP2(pos.x + *end * framePixelWidth + framePixelWidth, pos.y + ItemHeight - 2);
-                ImVec2 slotP3(pos.x + *end * framePixelWidth + framePixelWidth, pos.y + ItemHeight - 2 + localCustomHeight);
-                unsigned int slotColor = color | 0xFF000000;
-                unsigned int slotColorHalf = (color & 0xFFFFFF) | 0x40000000;
-
-                if (slotP1.x <= (canvas_size.x + contentMin.x) && slotP2.x >= (contentMin.x + legendWidth))
+                IMGUIZMO_PROFILE_ZONE("ImSequencer::Slots");
+                for (int i = firstVisibleRow; i <= lastVisibleRow; i++)
                 {
-                    draw_list->AddRectFilled(slotP1, slotP3, slotColorHalf, 2);
-                    draw_list->AddRectFilled(slotP1, slotP2, slotColor, 2);
-                }
-                if (ImRect(slotP1, slotP2).Contains(io.MousePos) && io.MouseDoubleClicked[0])
-                {
-                    sequence->DoubleClick(i);
-                }
-                ImRect rects[3] = { ImRect(slotP1, ImVec2(slotP1.x + framePixelWidth / 2, slotP2.y))
-                    , ImRect(ImVec2(slotP2.x - framePixelWidth / 2, slotP1.y), slotP2)
-                    , ImRect(slotP1, slotP2) };
+                    size_t localCustomHeight = size_t(rowOffsets[i + 1] - rowOffsets[i] - ItemHeight);
+                    ImVec2 pos = ImVec2(framesX, contentMin.y + rowOffsets[i] + 1);
 
-                const unsigned int quadColor[] = { 0xFFFFFFFF, 0xFFFFFFFF, slotColor + (selected ? 0 : 0x202020) };
-                if (movingEntry == -1 && (sequenceOptions&SEQUENCER_EDIT_STARTEND))// TODOFOCUS && backgroundRect.Contains(io.MousePos))
-                {
-                    for (int j = 2; j >= 0; j--)
+                    int firstClip, lastClip;
+                    FindClips(sequence, spans, i, firstFrameUsed, lastVisibleFrame, firstClip, lastClip);
+                    for (int clip = firstClip; clip <= lastClip; clip++)
                     {
-                        ImRect& rc = rects[j];
-                        if (!rc.Contains(io.MousePos))
-                            continue;
-                        draw_list->AddRectFilled(rc.Min, rc.Max, quadColor[j], 2);
+                        int *start, *end;
+                        unsigned int color;
+                        FetchClip(sequence, spans, i, clip, &start, &end, &color);
+
+                        ImVec2 slotP1(pos.x + (*start - firstFrameUsed) * framePixelWidth, pos.y + 2);
+                        ImVec2 slotP2(pos.x + (*end - firstFrameUsed) * framePixelWidth + framePixelWidth, pos.y + ItemHeight - 2);
+                        ImVec2 slotP3(pos.x + (*end - firstFrameUsed) * framePixelWidth + framePixelWidth, pos.y + ItemHeight - 2 + localCustomHeight);
+                        unsigned int slotColor = color | 0xFF000000;
+                        unsigned int slotColorHalf = (color & 0xFFFFFF) | 0x40000000;
+
+                        draw_list->AddRectFilled(slotP1, slotP3, slotColorHalf, 2);
+                        draw_list->AddRectFilled(slotP1, slotP2, slotColor, 2);
+                        if (IsSelected(selection, { i, clip }))
+                            draw_list->AddRect(slotP1, slotP2, 0xFFFFFFFF, 2, 15, 2.f);
                     }
 
-                    for (int j = 0; j < 3; j++)
+                    // custom draw
+                    if (localCustomHeight > 0)
                     {
-                        ImRect& rc = rects[j];
-                        if (!rc.Contains(io.MousePos))
-                            continue;
-                        if (!ImRect(childFramePos, childFramePos+childFrameSize).Contains(io.MousePos))
-                            continue;
-                        if (ImGui::IsMouseClicked(0) && !MovingScrollBar && !MovingCurrentFrame)
-                        {
-                            movingEntry = i;
-                            movingPos = cx;
-                            movingPart = j + 1;
-                            sequence->BeginEdit(movingEntry);
-                            break;
-                        }
+                       ImVec2 rp(canvas_pos.x, contentMin.y + rowOffsets[i] + 1);
+                       ImRect customRect(rp + ImVec2(legendWidth - (firstFrameUsed - sequence->GetFrameMin() - 0.5f) * framePixelWidth, float(ItemHeight)),
+                          rp + ImVec2(legendWidth + (sequence->GetFrameMax() - firstFrameUsed - 0.5f + 2.f) * framePixelWidth, float(localCustomHeight + ItemHeight)));
+                       ImRect clippingRect(rp + ImVec2(float(legendWidth), float(ItemHeight)), rp + ImVec2(canvas_size.x, float(localCustomHeight + ItemHeight)));
+
+                        ImRect legendRect(rp + ImVec2(0.f, float(ItemHeight)), rp + ImVec2(float(legendWidth), float(localCustomHeight)));
+                        ImRect legendClippingRect(canvas_pos + ImVec2(0.f, float(ItemHeight)), canvas_pos + ImVec2(float(legendWidth), float(localCustomHeight + ItemHeight)));
+                        if (clippingRect.Overlaps(visibleRect))
+                            customDraws.push_back({ i, customRect, legendRect, clippingRect, legendClippingRect });
+                    }
+                    else
+                    {
+                       ImVec2 rp(canvas_pos.x, contentMin.y + rowOffsets[i]);
+                       ImRect customRect(rp + ImVec2(legendWidth - (firstFrameUsed - sequence->GetFrameMin() - 0.5f) * framePixelWidth, float(0.f)),
+                          rp + ImVec2(legendWidth + (sequence->GetFrameMax() - firstFrameUsed - 0.5f + 2.f) * framePixelWidth, float(ItemHeight)));
+                       ImRect clippingRect(rp + ImVec2(float(legendWidth), float(0.f)), rp + ImVec2(canvas_size.x, float(ItemHeight)));
+
+                       // compact draws live in the clip row, skipped when no clip is on screen
+                       if (firstClip <= lastClip && clippingRect.Overlaps(visibleRect))
+                          compactCustomDraws.push_back({ i, customRect, ImRect(), clippingRect, ImRect() });
                     }
                 }
+            }
 
-                // custom draw
-                if (localCustomHeight > 0)
-                {
-                   ImVec2 rp(canvas_pos.x, contentMin.y + ItemHeight * i + 1 + customHeight);
-                   ImRect customRect(rp + ImVec2(legendWidth - (firstFrameUsed - sequence->GetFrameMin() - 0.5f) * framePixelWidth, float(ItemHeight)),
-                      rp + ImVec2(legendWidth + (sequence->GetFrameMax() - firstFrameUsed - 0.5f + 2.f) * framePixelWidth, float(localCustomHeight + ItemHeight)));
-                   ImRect clippingRect(rp + ImVec2(float(legendWidth), float(ItemHeight)), rp + ImVec2(canvas_size.x, float(localCustomHeight + ItemHeight)));
-
-                    ImRect legendRect(rp + ImVec2(0.f, float(ItemHeight)), rp + ImVec2(float(legendWidth), float(localCustomHeight)));
-                    ImRect legendClippingRect(canvas_pos + ImVec2(0.f, float(ItemHeight)), canvas_pos + ImVec2(float(legendWidth), float(localCustomHeight + ItemHeight)));
-                    customDraws.push_back({ i, customRect, legendRect, clippingRect, legendClippingRect });
-                }
-                else
+            // clip under the mouse, by binary search in the hovered row
+            bool overSlot = false;
+            if (hoveredRow != -1 && cx > contentMin.x + legendWidth)
+            {
+                const float rowY = contentMin.y + rowOffsets[hoveredRow] + 1;
+                const int mouseFrame = firstFrameUsed + int(floorf((cx - framesX) / framePixelWidth));
+                int hoveredClip, lastClip;
+                FindClips(sequence, spans, hoveredRow, mouseFrame, mouseFrame, hoveredClip, lastClip);
+                if (hoveredClip <= lastClip && cy >= rowY + 2 && cy < rowY + ItemHeight - 2)
                 {
-                   ImVec2 rp(canvas_pos.x, contentMin.y + ItemHeight * i + customHeight);
-                   ImRect customRect(rp + ImVec2(legendWidth - (firstFrameUsed - sequence->GetFrameMin() - 0.5f) * framePixelWidth, float(0.f)),
-                      rp + ImVec2(legendWidth + (sequence->GetFrameMax() - firstFrameUsed - 0.5f + 2.f) * framePixelWidth, float(ItemHeight)));
-                   ImRect clippingRect(rp + ImVec2(float(legendWidth), float(0.f)), rp + ImVec2(canvas_size.x, float(ItemHeight)));
+                    int *start, *end;
+                    unsigned int color;
+                    FetchClip(sequence, spans, hoveredRow, hoveredClip, &start, &end, &color);
+                    ImVec2 slotP1(framesX + (*start - firstFrameUsed) * framePixelWidth, rowY + 2);
+                    ImVec2 slotP2(framesX + (*end - firstFrameUsed) * framePixelWidth + framePixelWidth, rowY + ItemHeight - 2);
+                    unsigned int slotColor = color | 0xFF000000;
+
+                    overSlot = true;
+                    if (io.MouseDoubleClicked[0])
+                        sequence->DoubleClick(hoveredRow);
+
+                    ImRect rects[3] = { ImRect(slotP1, ImVec2(slotP1.x + framePixelWidth / 2, slotP2.y))
+                        , ImRect(ImVec2(slotP2.x - framePixelWidth / 2, slotP1.y), slotP2)
+                        , ImRect(slotP1, slotP2) };
+
+                    const unsigned int quadColor[] = { 0xFFFFFFFF, 0xFFFFFFFF, slotColor + (selected ? 0 : 0x202020) };
+                    if (movingEntry == -1 && (sequenceOptions&SEQUENCER_EDIT_STARTEND))// TODOFOCUS && backgroundRect.Contains(io.MousePos))
+                    {
+                        for (int j = 2; j >= 0; j--)
+                        {
+                            ImRect& rc = rects[j];
+                            if (!rc.Contains(io.MousePos))
+                                continue;
+                            draw_list->AddRectFilled(rc.Min, rc.Max, quadColor[j], 2);
+                        }
 
-                   compactCustomDraws.push_back({ i, customRect, ImRect(), clippingRect, ImRect() });
+                        for (int j = 0; j < 3; j++)
+                        {
+                            ImRect& rc = rects[j];
+                            if (!rc.Contains(io.MousePos))
+                                continue;
+                            if (!ImRect(childFramePos, childFramePos+childFrameSize).Contains(io.MousePos))
+                                continue;
+                            if (ImGui::IsMouseClicked(0) && !MovingScrollBar && !MovingCurrentFrame)
+                            {
+                                const ClipIndex clickedClip = { hoveredRow, hoveredClip };
+                                // ctrl/shift click toggles the selection, click drags the whole selection
+                                if (io.KeyCtrl || io.KeyShift)
+                                {
+                                    ToggleSelection(selection, clickedClip);
+                                    if (selectedEntry)
+                                        *selectedEntry = hoveredRow;
+                                    ret = true;
+                                    break;
+                                }
+                                if (!IsSelected(selection, clickedClip))
+                                {
+                                    selection.resize(0);
+                                    selection.push_back(clickedClip);
+                                }
+                                movedEntries = false;
+                                movingEntry = hoveredRow;
+                                movingClip = hoveredClip;
+                                movingPos = cx;
+                                movingPart = j + 1;
+                                sequence->BeginEdit(movingEntry);
+                                break;
+                            }
+                        }
+                    }
                 }
-                customHeight += localCustomHeight;
             }
 
-
             // moving
             if (/*backgroundRect.Contains(io.MousePos) && */movingEntry >= 0)
             {
@@ -402,34 +725,77 @@ namespace ImSequencer
                 int diffFrame = int((cx - movingPos) / framePixelWidth);
                 if (std::abs(diffFrame) > 0)
                 {
-                    int *start, *end;
-                    sequence->Get(movingEntry, &start, &end, NULL, NULL);
                     if (selectedEntry)
                         *selectedEntry = movingEntry;
-                    int & l = *start;
-                    int & r = *end;
-                    if (movingPart & 1)
-                        l += diffFrame;
-                    if (movingPart & 2)
-                        r += diffFrame;
-                    if (l < 0)
+                    // every selected clip is moved or trimmed by the same amount, in one edit
+                    const ClipIndex movedClip = { movingEntry, movingClip };
+                    const bool movingSelection = IsSelected(selection, movedClip);
+                    const int clipCount = movingSelection ? selection.Size : 1;
+
+                    // clamp the amount so clips stay after frame 0 and don't cross a neighbour that doesn't move along
+                    for (int k = 0; k < clipCount; k++)
+                    {
+                        const ClipIndex clip = movingSelection ? selection[k] : movedClip;
+                        if (clip.entry >= sequenceCount)
+                            continue;
+                        int *start, *end;
+                        FetchClip(sequence, spans, clip.entry, clip.clip, &start, &end, NULL);
+                        if (movingPart & 1)
+                        {
+                            int lowest = 0;
+                            if (clip.clip > 0 && !(movingPart == 3 && IsSelected(selection, { clip.entry, clip.clip - 1 })))
+                            {
+                                int *previousEnd;
+                                FetchClip(sequence, spans, clip.entry, clip.clip - 1, NULL, &previousEnd, NULL);
+                                lowest = ImMax(lowest, *previousEnd + 1);
+                            }
+                            diffFrame = ImMax(diffFrame, lowest - *start);
+                        }
+                        if ((movingPart & 2) && clip.clip < ClipCount(sequence, spans, clip.entry) - 1 && !(movingPart == 3 && IsSelected(selection, { clip.entry, clip.clip + 1 })))
+                        {
+                            int *nextStart;
+                            FetchClip(sequence, spans, clip.entry, clip.clip + 1, &nextStart, NULL, NULL);
+                            diffFrame = ImMin(diffFrame, *nextStart - 1 - *end);
+                        }
+                    }
+
+                    for (int k = 0; k < clipCount && diffFrame; k++)
                     {
+                        const ClipIndex clip = movingSelection ? selection[k] : movedClip;
+                        if (clip.entry >= sequenceCount)
+                            continue;
+                        int *start, *end;
+                        FetchClip(sequence, spans, clip.entry, clip.clip, &start, &end, NULL);
+                        int & l = *start;
+                        int & r = *end;
+                        if (movingPart & 1)
+                            l += diffFrame;
                         if (movingPart & 2)
-                            r -= l;
-                        l = 0;
+                            r += diffFrame;
+                        if (l < 0)
+                        {
+                            if (movingPart & 2)
+                                r -= l;
+                            l = 0;
+                        }
+                        if (movingPart & 1 && l > r)
+                            l = r;
+                        if (movingPart & 2 && r < l)
+                            r = l;
                     }
-                    if (movingPart & 1 && l > r)
-                        l = r;
-                    if (movingPart & 2 && r < l)
-                        r = l;
+                    if (diffFrame)
+                        movedEntries = true;
                     movingPos += int(diffFrame * framePixelWidth);
                 }
                 if (!io.MouseDown[0])
                 {
                     // single select
-                    if (!diffFrame && movingPart && selectedEntry)
+                    if (!movedEntries && movingPart)
                     {
-                        *selectedEntry = movingEntry;
+                        selection.resize(0);
+                        selection.push_back({ movingEntry, movingClip });
+                        if (selectedEntry)
+                            *selectedEntry = movingEntry;
                         ret = true;
                     }
 
@@ -438,24 +804,69 @@ namespace ImSequencer
                 }
             }
 
+            // rubber band selection, starting from an empty spot of a clip row. Custom draw areas belong to the sequence
+            bool overClipRow = hoveredRow != -1 && cy < contentMin.y + rowOffsets[hoveredRow] + ItemHeight;
+            for (int i = 0; overClipRow && i < customDraws.Size; i++)
+                overClipRow = !customDraws[i].clippingRect.Contains(io.MousePos);
+            if (!selectingBand && !overSlot && overClipRow && movingEntry == -1 && !MovingScrollBar && !MovingCurrentFrame && !popupOpened && ImGui::IsMouseClicked(0) &&
+                cx > contentMin.x + legendWidth && ImRect(childFramePos, childFramePos + childFrameSize).Contains(io.MousePos))
+            {
+                selectingBand = true;
+                bandOrigin = io.MousePos;
+            }
+            if (selectingBand)
+            {
+                const ImRect band(ImMin(bandOrigin, io.MousePos), ImMax(bandOrigin, io.MousePos));
+                draw_list->AddRectFilled(band.Min, band.Max, 0x401080FF);
+                draw_list->AddRect(band.Min, band.Max, 0xFF1080FF);
+                if (!io.MouseDown[0])
+                {
+                    if (!io.KeyShift && !io.KeyCtrl)
+                        selection.resize(0);
+                    const int bandFirstRow = FindRow(rowOffsets, int(band.Min.y - contentMin.y));
+                    const int bandLastRow = FindRow(rowOffsets, int(band.Max.y - contentMin.y));
+                    const int bandFirstFrame = firstFrameUsed + int(floorf((band.Min.x - framesX) / framePixelWidth));
+                    const int bandLastFrame = firstFrameUsed + int(floorf((band.Max.x - framesX) / framePixelWidth));
+                    for (int i = bandFirstRow; i <= bandLastRow; i++)
+                    {
+                        const float slotY = contentMin.y + rowOffsets[i] + 1;
+                        if (band.Max.y < slotY + 2 || band.Min.y >= slotY + ItemHeight - 2)
+                            continue;
+                        int firstClip, lastClip;
+                        FindClips(sequence, spans, i, bandFirstFrame, bandLastFrame, firstClip, lastClip);
+                        for (int clip = firstClip; clip <= lastClip; clip++)
+                        {
+                            if (!IsSelected(selection, { i, clip }))
+                                ToggleSelection(selection, { i, clip });
+                        }
+                    }
+                    if (selectedEntry)
+                        *selectedEntry = selection.empty() ? -1 : selection[0].entry;
+                    selectingBand = false;
+                    ret = true;
+                }
+            }
+
             // cursor
             if (currentFrame && firstFrame && *currentFrame >= *firstFrame && *currentFrame <= sequence->GetFrameMax())
             {
                 static const float cursorWidth = 8.f;
                 float cursorOffset = contentMin.x + legendWidth + (*currentFrame - firstFrameUsed) * framePixelWidth + framePixelWidth / 2 - cursorWidth * 0.5f;
                 draw_list->AddLine(ImVec2(cursorOffset, canvas_pos.y), ImVec2(cursorOffset, contentMax.y), 0xA02A2AFF, cursorWidth);
-                char tmps[512];
-                sprintf(tmps, "%d", *currentFrame);
-                draw_list->AddText(ImVec2(cursorOffset + 10, canvas_pos.y + 2), 0xFF2A2AFF, tmps);
+                draw_list->AddText(ImVec2(cursorOffset + 10, canvas_pos.y + 2), 0xFF2A2AFF, labels.Get(*currentFrame, frameRate));
             }
 
             draw_list->PopClipRect();
             draw_list->PopClipRect();
 
-            for (auto& customDraw : customDraws)
-                sequence->CustomDraw(customDraw.index, draw_list, customDraw.customRect, customDraw.legendRect, customDraw.clippingRect, customDraw.legendClippingRect);
-            for (auto& customDraw : compactCustomDraws)
-               sequence->CustomDrawCompact(customDraw.index, draw_list, customDraw.customRect, customDraw.clippingRect);
+            {
+                IMGUIZMO_PROFILE_ZONE("ImSequencer::CustomDraws");
+                const FrameRange visibleFrames = { firstFrameUsed, ImMin(lastVisibleFrame, sequence->GetFrameMax()) };
+                for (auto& customDraw : customDraws)
+                    sequence->CustomDraw(customDraw.index, draw_list, customDraw.customRect, customDraw.legendRect, customDraw.clippingRect, customDraw.legendClippingRect, visibleFrames);
+                for (auto& customDraw : compactCustomDraws)
+                    sequence->CustomDrawCompact(customDraw.index, draw_list, customDraw.customRect, customDraw.clippingRect, visibleFrames);
+            }
 
             // copy paste
             if (sequenceOptions&SEQUENCER_COPYPASTE)
@@ -515,8 +926,8 @@ namespace ImSequencer
                 bool onLeft = barHandleLeft.Contains(io.MousePos);
                 bool onRight = barHandleRight.Contains(io.MousePos);
 
-                static bool sizingRBar = false;
-                static bool sizingLBar = false;
+                bool& sizingRBar = state.sizingRBar;
+                bool& sizingLBar = state.sizingLBar;
 
                 draw_list->AddRectFilled(barHandleLeft.Min, barHandleLeft.Max, (onLeft || sizingLBar)?0xFFAAAAAA:0xFF666666, 6);
                 draw_list->AddRectFilled(barHandleRight.Min, barHandleRight.Max, (onRight || sizingRBar )?0xFFAAAAAA:0xFF666666, 6);
@@ -593,6 +1004,13 @@ namespace ImSequencer
                          panningViewSource = io.MousePos;
                          panningViewFrame = -*firstFrame;
                       }
+                      // double click on the bar zooms to fit the whole range
+                      if (ImRect(scrollBarMin, scrollBarMax).Contains(io.MousePos) && ImGui::IsMouseDoubleClicked(0) && firstFrame)
+                      {
+                         MovingScrollBar = false;
+                         framePixelWidthTarget = framePixelWidth = fitFramePixelWidth;
+                         *firstFrame = sequence->GetFrameMin();
+                      }
                       if (!sizingRBar && onRight && ImGui::IsMouseClicked(0))
                          sizingRBar = true;
                       if (!sizingLBar && onLeft && ImGui::IsMouseClicked(0))
@@ -655,6 +1073,8 @@ namespace ImSequencer
 
         if (delEntry != -1)
         {
+            // indices after the deleted one are shifted
+            selection.resize(0);
             sequence->Del(delEntry);
             if (selectedEntry && (*selectedEntry == delEntry || *selectedEntry >= sequence->GetItemCount()))
                 *selectedEntry = -1;
@@ -664,6 +1084,13 @@ namespace ImSequencer
         {
             sequence->Duplicate(dupEntry);
         }
+
+        if (selectedClips)
+        {
+            selectedClips->resize(selection.Size);
+            for (int i = 0; i < selection.Size; i++)
+                (*selectedClips)[i] = selection[i];
+        }
         return ret;
     }
 }
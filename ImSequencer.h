@@ -4,6 +4,7 @@
 
 struct ImDrawList;
 struct ImRect;
+template<typename T> struct ImVector;
 namespace ImSequencer
 {
     enum SEQUENCER_OPTIONS
@@ -17,12 +18,46 @@ namespace ImSequencer
         SEQUENCER_EDIT_ALL = SEQUENCER_EDIT_STARTEND | SEQUENCER_CHANGE_FRAME
     };
 
+    struct ClipIndex
+    {
+        int entry;
+        int clip;
+        bool operator <(const ClipIndex& other) const
+        {
+            if (entry != other.entry)
+                return entry < other.entry;
+            return clip < other.clip;
+        }
+    };
+
+    // direct access to the items data, either as parallel arrays (stride = sizeof(int))
+    // or as pointers to the fields of the first element of an array of structs (stride = sizeof(struct)).
+    // start, end and color are all required.
+    // Spans and multiple clips are mutually exclusive: when GetSpans returns true, every item is a single clip
+    // and GetClipCount/GetClip are not called.
+    struct ItemSpans
+    {
+        int *start = NULL;
+        int *end = NULL;
+        const unsigned int *color = NULL;
+        size_t stride = sizeof(int);
+    };
+
+    // frames on screen, last included
+    struct FrameRange
+    {
+        int first;
+        int last;
+    };
+
     struct SequenceInterface
     {
         bool focused = false;
         virtual int GetFrameMin() const = 0;
         virtual int GetFrameMax() const = 0;
         virtual int GetItemCount() const = 0;
+        // frames per second. When > 0, the ruler and cursor display SMPTE timecode (hh:mm:ss:ff) instead of frame numbers
+        virtual int GetFrameRate() const { return 0; }
 
         virtual void BeginEdit(int /*index*/) {}
         virtual void EndEdit() {}
@@ -31,6 +66,12 @@ namespace ImSequencer
         virtual const char *GetItemLabel(int /*index*/) const { return ""; }
 
         virtual void Get(int index, int** start, int** end, int *type, unsigned int *color) = 0;
+        // optional bulk accessor used instead of Get, GetClipCount and GetClip when it returns true.
+        // Spans are queried once per frame
+        virtual bool GetSpans(ItemSpans& /*spans*/) { return false; }
+        // items may hold several clips, sorted on start and not overlapping. By default an item is the single clip returned by Get
+        virtual int GetClipCount(int /*index*/) { return 1; }
+        virtual void GetClip(int index, int /*clipIndex*/, int** start, int** end, unsigned int *color) { Get(index, start, end, NULL, color); }
         virtual void Add(int /*type*/) {}
         virtual void Del(int /*index*/) {}
         virtual void Duplicate(int /*index*/) {}
@@ -39,13 +80,23 @@ namespace ImSequencer
         virtual void Paste() {}
 
         virtual size_t GetCustomHeight(int /*index*/) { return 0; }
+        // bump the returned value whenever an item custom height changes so row offsets are only
+        // recomputed then. 0 means unversioned: heights are queried every frame
+        virtual unsigned int GetLayoutVersion() const { return 0; }
         virtual void DoubleClick(int /*index*/) {}
-        virtual void CustomDraw(int /*index*/, ImDrawList* /*draw_list*/, const ImRect& /*rc*/, const ImRect& /*legendRect*/, const ImRect& /*clippingRect*/, const ImRect& /*legendClippingRect*/) {}
-        virtual void CustomDrawCompact(int /*index*/, ImDrawList* /*draw_list*/, const ImRect& /*rc*/, const ImRect& /*clippingRect*/) {}
+        // visibleFrames is the frame range on screen, content outside of it can be skipped
+        virtual void CustomDraw(int /*index*/, ImDrawList* /*draw_list*/, const ImRect& /*rc*/, const ImRect& /*legendRect*/, const ImRect& /*clippingRect*/, const ImRect& /*legendClippingRect*/, const FrameRange& /*visibleFrames*/) {}
+        virtual void CustomDrawCompact(int /*index*/, ImDrawList* /*draw_list*/, const ImRect& /*rc*/, const ImRect& /*clippingRect*/, const FrameRange& /*visibleFrames*/) {}
     };
 
 
     // return true if selection is made
-    bool Sequencer(SequenceInterface *sequence, int *currentFrame, bool *expanded, int *selectedEntry, int *firstFrame, int sequenceOptions);
+    // click selects and drags an entry, ctrl/shift + click toggles it, dragging from an empty spot selects with a band.
+    // Zoom, drag and selection state is kept per widget, keyed by the ImGui ID of the sequence pointer.
+    // Dragging a clip of the selection moves or trims the whole selection within a single BeginEdit/EndEdit.
+    // selectedClips optionally receives the selected clips
+    bool Sequencer(SequenceInterface *sequence, int *currentFrame, bool *expanded, int *selectedEntry, int *firstFrame, int sequenceOptions, ImVector<ClipIndex> *selectedClips = NULL);
+    // frees the state of every sequencer, in every ImGui context. Call it before destroying the ImGui context
+    void ClearState();
 
 }
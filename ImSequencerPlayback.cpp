@@ -0,0 +1,171 @@
+#include "ImSequencerPlayback.h"
+#include <chrono>
+#include <math.h>
+
+namespace ImSequencer
+{
+    int64_t Playback::Now() const
+    {
+        if (clock)
+            return clock();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void Playback::Anchor(double frame, int64_t time)
+    {
+        position = frame;
+        anchorFrame = frame;
+        anchorTime = time;
+    }
+
+    // frames played: the loop when looping, the whole range otherwise. last is exclusive
+    void Playback::GetPlayRange(double& first, double& last) const
+    {
+        const bool looping = loopEnd >= loopStart;
+        first = looping ? double(loopStart) : double(rangeMin);
+        last = (looping ? double(loopEnd) : double(rangeMax)) + 1.0;
+    }
+
+    // moves position to the current time, wrapping in the loop or stopping at the end of the range
+    void Playback::Advance(int64_t now)
+    {
+        if (!playing)
+            return;
+        double first, last;
+        GetPlayRange(first, last);
+        // from the anchor rather than accumulated deltas, so the playhead doesn't drift
+        double frame = anchorFrame + double(now - anchorTime) * 1e-9 * frameRate * rate;
+        if (loopEnd >= loopStart)
+        {
+            if (frame >= last || frame < first)
+            {
+                frame = first + fmod(frame - first, last - first);
+                if (frame < first)
+                    frame += last - first;
+                Anchor(frame, now);
+            }
+        }
+        else if (frame >= last || frame < first)
+        {
+            // stop on the last frame played
+            frame = (frame < first) ? first : last - 1.0;
+            playing = false;
+            Anchor(frame, now);
+        }
+        position = frame;
+    }
+
+    void Playback::SetFrameRate(double framesPerSecond)
+    {
+        // re-anchor at the current position so the change doesn't jump the playhead
+        const int64_t now = Now();
+        Advance(now);
+        Anchor(position, now);
+        frameRate = framesPerSecond;
+        Publish();
+    }
+
+    void Playback::SetRange(int frameMin, int frameMax)
+    {
+        rangeMin = frameMin;
+        rangeMax = frameMax;
+    }
+
+    void Playback::SetLoop(int start, int end)
+    {
+        loopStart = start;
+        loopEnd = end;
+    }
+
+    void Playback::SetRate(float newRate)
+    {
+        const int64_t now = Now();
+        Advance(now);
+        Anchor(position, now);
+        rate = newRate;
+        Publish();
+    }
+
+    void Playback::Play()
+    {
+        if (playing)
+            return;
+        playing = true;
+        Anchor(position, Now());
+    }
+
+    void Playback::Pause()
+    {
+        if (!playing)
+            return;
+        Update(NULL);
+        playing = false;
+        Anchor(position, Now());
+        Publish();
+    }
+
+    void Playback::Scrub(int frame)
+    {
+        scrubPending = true;
+        scrubFrame = frame;
+    }
+
+    bool Playback::Update(int* currentFrame)
+    {
+        const int64_t now = Now();
+        if (currentFrame && *currentFrame != lastFrame && !scrubPending)
+            Scrub(*currentFrame);
+
+        double first, last;
+        GetPlayRange(first, last);
+        if (scrubPending)
+        {
+            scrubPending = false;
+            Anchor(fmin(fmax(double(scrubFrame), first), last - 1.0), now);
+        }
+        else
+        {
+            Advance(now);
+        }
+
+        Publish();
+        // lastFrame mirrors the host frame, only tracked when it is written
+        if (!currentFrame)
+            return false;
+        const int frame = int(floor(position));
+        const bool changed = frame != *currentFrame;
+        lastFrame = frame;
+        *currentFrame = frame;
+        return changed;
+    }
+
+    void Playback::Publish()
+    {
+        const uint32_t count = sequence.load(std::memory_order_relaxed);
+        sequence.store(count + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        publishedFrame.store(anchorFrame, std::memory_order_relaxed);
+        publishedSpeed.store(playing ? frameRate * rate : 0.0, std::memory_order_relaxed);
+        publishedTime.store(anchorTime, std::memory_order_relaxed);
+        publishedPlaying.store(playing, std::memory_order_relaxed);
+        sequence.store(count + 2, std::memory_order_release);
+    }
+
+    PlayheadState Playback::ReadPlayhead() const
+    {
+        PlayheadState state;
+        for (;;)
+        {
+            const uint32_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1)
+                continue;
+            state.frame = publishedFrame.load(std::memory_order_relaxed);
+            state.framesPerSecond = publishedSpeed.load(std::memory_order_relaxed);
+            state.time = publishedTime.load(std::memory_order_relaxed);
+            state.playing = publishedPlaying.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before)
+                return state;
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+namespace ImSequencer
+{
+    // playhead as seen by other threads, extrapolate with frame + (now - time) * framesPerSecond when playing
+    struct PlayheadState
+    {
+        double frame = 0.0;
+        double framesPerSecond = 0.0;   // frame rate times playback rate, 0 when paused
+        int64_t time = 0;               // steady clock, nanoseconds
+        bool playing = false;
+    };
+
+    // play/pause/loop/rate controller driving the sequencer currentFrame from a monotonic clock.
+    // All methods but ReadPlayhead are for the UI thread. Call Update once per UI frame, before Sequencer.
+    // ReadPlayhead is lock-free and can be called from one audio or evaluation thread.
+    struct Playback
+    {
+        // monotonic clock in nanoseconds, the steady clock when NULL. Playhead times are read from it
+        typedef int64_t (*Clock)();
+        void SetClock(Clock now) { clock = now; }
+        void SetFrameRate(double framesPerSecond);
+        void SetRange(int frameMin, int frameMax);
+        void SetLoop(int start, int end);      // end < start disables looping
+        void SetRate(float rate);                 // negative plays backward
+        void Play();
+        void Pause();
+        bool IsPlaying() const { return playing; }
+
+        // scrubs are coalesced, only the last one before Update is applied. The frame is clamped to the loop when looping,
+        // to the range otherwise
+        void Scrub(int frame);
+
+        // advances the playhead, writes it to currentFrame and publishes it. Returns true when currentFrame changed.
+        // a currentFrame modified by the host since the last Update is taken as a scrub
+        bool Update(int* currentFrame);
+
+        double GetPosition() const { return position; }
+        PlayheadState ReadPlayhead() const;
+
+    private:
+        int64_t Now() const;
+        void Anchor(double frame, int64_t time);
+        void Advance(int64_t now);
+        void GetPlayRange(double& first, double& last) const;
+        void Publish();
+
+        Clock clock = NULL;
+        double frameRate = 24.0;
+        float rate = 1.f;
+        int rangeMin = 0;
+        int rangeMax = 0;
+        int loopStart = 0;
+        int loopEnd = -1;
+        bool playing = false;
+        bool scrubPending = false;
+        int scrubFrame = 0;
+        int lastFrame = 0;
+
+        double position = 0.0;
+        double anchorFrame = 0.0;
+        int64_t anchorTime = 0;
+
+        // seqlock, the UI thread being the only writer
+        std::atomic<uint32_t> sequence{ 0 };
+        std::atomic<double> publishedFrame{ 0.0 };
+        std::atomic<double> publishedSpeed{ 0.0 };
+        std::atomic<int64_t> publishedTime{ 0 };
+        std::atomic<bool> publishedPlaying{ false };
+    };
+}
@@ -0,0 +1,107 @@
+#include "ImSequencerWaveform.h"
+#include "imgui_internal.h"
+#include <math.h>
+
+namespace ImSequencer
+{
+    void WaveformMipmap::Clear()
+    {
+        sampleCount = 0;
+        levels.clear();
+        levelOffsets.clear();
+    }
+
+    void WaveformMipmap::Build(const float* samples, size_t count, size_t stride)
+    {
+        Clear();
+        sampleCount = count;
+
+        // level 0 keeps a pair per sample so every level is read the same way
+        size_t levelSize = count;
+        size_t total = 0;
+        for (size_t size = count; size > 1; size = (size + 1) / 2)
+            total += size;
+        total += 1;
+        levels.reserve(int(total));
+
+        levelOffsets.push_back(0);
+        for (size_t i = 0; i < count; i++)
+        {
+            const float value = samples[i * stride];
+            levels.push_back(ImVec2(value, value));
+        }
+        while (levelSize > 1)
+        {
+            const size_t source = levelOffsets.back();
+            const size_t nextSize = (levelSize + 1) / 2;
+            levelOffsets.push_back(size_t(levels.Size));
+            for (size_t i = 0; i < nextSize; i++)
+            {
+                const ImVec2 a = levels[int(source + i * 2)];
+                const ImVec2 b = (i * 2 + 1 < levelSize) ? levels[int(source + i * 2 + 1)] : a;
+                levels.push_back(ImVec2(ImMin(a.x, b.x), ImMax(a.y, b.y)));
+            }
+            levelSize = nextSize;
+        }
+    }
+
+    void WaveformMipmap::GetRange(size_t first, size_t last, float& minValue, float& maxValue) const
+    {
+        minValue = FLT_MAX;
+        maxValue = -FLT_MAX;
+        last = ImMin(last, sampleCount);
+        // greedy decomposition in aligned blocks, at most two entries per level
+        while (first < last)
+        {
+            int level = 0;
+            while (level + 1 < levelOffsets.Size && !(first & ((size_t(1) << (level + 1)) - 1)) && first + (size_t(1) << (level + 1)) <= last)
+                level++;
+            const ImVec2& entry = levels[int(levelOffsets[level] + (first >> level))];
+            minValue = ImMin(minValue, entry.x);
+            maxValue = ImMax(maxValue, entry.y);
+            first += size_t(1) << level;
+        }
+    }
+
+    void WaveformMipmap::GetColumns(double firstFrame, float framePixelWidth, float samplesPerFrame, ImVec2* minMax, int columnCount) const
+    {
+        const double samplesPerColumn = double(samplesPerFrame) / double(framePixelWidth);
+        const double firstSample = firstFrame * double(samplesPerFrame);
+        for (int i = 0; i < columnCount; i++)
+        {
+            const double begin = firstSample + i * samplesPerColumn;
+            const double end = begin + samplesPerColumn;
+            if (end <= 0.0 || begin >= double(sampleCount))
+            {
+                minMax[i] = ImVec2(1.f, -1.f);
+                continue;
+            }
+            // zoomed in, a column still shows the sample it lies on
+            const size_t first = size_t(ImMax(floor(begin), 0.0));
+            const size_t last = ImMax(size_t(ceil(end)), first + 1);
+            GetRange(first, last, minMax[i].x, minMax[i].y);
+        }
+    }
+
+    void WaveformMipmap::Draw(ImDrawList* draw_list, const ImRect& rc, double firstFrame, float framePixelWidth, float samplesPerFrame, unsigned int color) const
+    {
+        const int columnCount = int(ceilf(rc.GetWidth()));
+        if (columnCount <= 0 || !sampleCount)
+            return;
+        columns.resize(columnCount);
+        GetColumns(firstFrame, framePixelWidth, samplesPerFrame, columns.Data, columnCount);
+
+        const float midY = (rc.Min.y + rc.Max.y) * 0.5f;
+        const float halfHeight = rc.GetHeight() * 0.5f;
+        for (int i = 0; i < columnCount; i++)
+        {
+            const ImVec2& column = columns[i];
+            if (column.x > column.y)
+                continue;
+            const float x = rc.Min.x + float(i) + 0.5f;
+            const float top = midY - ImClamp(column.y, -1.f, 1.f) * halfHeight;
+            const float bottom = midY - ImClamp(column.x, -1.f, 1.f) * halfHeight;
+            draw_list->AddLine(ImVec2(x, top), ImVec2(x, ImMax(bottom, top + 1.f)), color);
+        }
+    }
+}
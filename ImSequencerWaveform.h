@@ -0,0 +1,33 @@
+#pragma once
+#include <stddef.h>
+#include "imgui.h"
+
+struct ImDrawList;
+struct ImRect;
+namespace ImSequencer
+{
+    // min/max pyramid over a sample stream, built once, so drawing a waveform costs one min/max pair per pixel
+    // column at any zoom level. Level 0 is the samples, level n holds the min/max of 2^n samples
+    struct WaveformMipmap
+    {
+        void Build(const float* samples, size_t count, size_t stride = 1);
+        void Clear();
+        size_t GetSampleCount() const { return sampleCount; }
+
+        // min/max of samples [first, last), exact
+        void GetRange(size_t first, size_t last, float& minValue, float& maxValue) const;
+
+        // one min/max pair per column. Column i covers frames [firstFrame + i / framePixelWidth, firstFrame + (i + 1) / framePixelWidth),
+        // sample 0 being at frame 0. Columns outside the samples get an empty (min > max) pair
+        void GetColumns(double firstFrame, float framePixelWidth, float samplesPerFrame, ImVec2* minMax, int columnCount) const;
+
+        // draw the waveform in rc, its left edge showing firstFrame. Samples are expected in [-1, 1]
+        void Draw(ImDrawList* draw_list, const ImRect& rc, double firstFrame, float framePixelWidth, float samplesPerFrame, unsigned int color) const;
+
+    private:
+        size_t sampleCount = 0;
+        ImVector<ImVec2> levels;          // all levels, from the finest
+        ImVector<size_t> levelOffsets;    // offset of each level in levels, level 0 being the samples themselves
+        mutable ImVector<ImVec2> columns; // Draw scratch
+    };
+}
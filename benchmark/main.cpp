@@ -0,0 +1,272 @@
+#include <imgui.h>
+
+#include "ImGuizmo.h"
+#include "ImSequencer.h"
+#include "ImCurveEdit.h"
+#include "ImGradient.h"
+#include "ImGradientStops.h"
+#include "imgui_internal.h"
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+//
+//
+// Headless benchmark: an ImGui context without backend, synthetic input over a number of frames,
+// per frame CPU time and vertex count for each widget at several scales.
+// usage: imguizmo_benchmark [frameCount] [budgetScale]
+//        imguizmo_benchmark test
+// Every widget and scale has its own mean frame time budget, multiplied by budgetScale (0, the default, disables them).
+// Budgets are release timings, they are only checked in builds defining NDEBUG.
+// Exits with 1 when a mean frame time exceeds its budget or a draw list holds more vertices than 16-bit indices address.
+// "test" runs the unit tests of tests.cpp instead.
+//
+//
+
+struct CurveBench : public ImCurveEdit::Delegate
+{
+   CurveBench(int pointCount) : mPts(pointCount), mMin(0.f, 0.f), mMax(float(pointCount), 1.f)
+   {
+      for (int i = 0; i < pointCount; i++)
+         mPts[i] = ImVec2(float(i), 0.5f + 0.5f * sinf(float(i) * 0.1f));
+   }
+
+   size_t GetCurveCount() { return 1; }
+   ImVec2& GetMin() { return mMin; }
+   ImVec2& GetMax() { return mMax; }
+   size_t GetPointCount(size_t) { return mPts.size(); }
+   uint32_t GetCurveColor(size_t) { return 0xFF0000FF; }
+   ImVec2* GetPoints(size_t) { return mPts.data(); }
+   virtual ImCurveEdit::CurveType GetCurveType(size_t) const { return ImCurveEdit::CurveSmooth; }
+   virtual unsigned int GetCurveVersion(size_t) { return mVersion; }
+   virtual int EditPoint(size_t, int pointIndex, ImVec2 value)
+   {
+      // keep x order, the benchmark only cares about the cost of a drag
+      value.x = ImClamp(value.x, pointIndex ? mPts[pointIndex - 1].x : -FLT_MAX, pointIndex + 1 < int(mPts.size()) ? mPts[pointIndex + 1].x : FLT_MAX);
+      mPts[pointIndex] = value;
+      mVersion++;
+      return pointIndex;
+   }
+   virtual void AddPoint(size_t, ImVec2) {}
+
+   std::vector<ImVec2> mPts;
+   ImVec2 mMin;
+   ImVec2 mMax;
+   unsigned int mVersion = 1;
+};
+
+struct SequenceBench : public ImSequencer::SequenceInterface
+{
+   SequenceBench(int itemCount) : mStart(itemCount), mEnd(itemCount), mColor(itemCount, 0xFFAA8080)
+   {
+      for (int i = 0; i < itemCount; i++)
+      {
+         mStart[i] = (i * 7) % 500;
+         mEnd[i] = mStart[i] + 10 + (i % 40);
+      }
+   }
+
+   virtual int GetFrameMin() const { return 0; }
+   virtual int GetFrameMax() const { return 600; }
+   virtual int GetItemCount() const { return int(mStart.size()); }
+   virtual void Get(int index, int** start, int** end, int* type, unsigned int* color)
+   {
+      if (start)
+         *start = &mStart[index];
+      if (end)
+         *end = &mEnd[index];
+      if (type)
+         *type = 0;
+      if (color)
+         *color = mColor[index];
+   }
+   virtual bool GetSpans(ImSequencer::ItemSpans& spans)
+   {
+      spans.start = mStart.data();
+      spans.end = mEnd.data();
+      spans.color = mColor.data();
+      return true;
+   }
+   virtual unsigned int GetLayoutVersion() const { return 1; }
+
+   std::vector<int> mStart;
+   std::vector<int> mEnd;
+   std::vector<unsigned int> mColor;
+};
+
+int RunTests();
+
+struct Result
+{
+   const char* widget;
+   int scale;
+   double meanMs;
+   double maxMs;
+   int vertexCount;
+   int maxListVertexCount; // largest draw list
+};
+
+// mean frame time budgets in ms, release build on a desktop CPU
+struct Budget
+{
+   const char* widget;
+   int scale;
+   double meanMs;
+};
+
+static const Budget budgets[] = {
+   { "ImCurveEdit", 10, 0.5 }, { "ImCurveEdit", 1000, 1.0 }, { "ImCurveEdit", 100000, 8.0 },
+   { "ImSequencer", 10, 0.5 }, { "ImSequencer", 1000, 1.0 }, { "ImSequencer", 100000, 4.0 },
+   { "ImGradient", 10, 0.5 }, { "ImGradient", 1000, 1.0 }, { "ImGradient", 100000, 4.0 },
+   { "ImGuizmo", 1, 0.5 }, { "ImGuizmo", 10, 1.0 }, { "ImGuizmo", 100, 6.0 },
+};
+
+static double GetBudget(const Result& result)
+{
+   for (const Budget& budget : budgets)
+   {
+      if (!strcmp(budget.widget, result.widget) && budget.scale == result.scale)
+         return budget.meanMs;
+   }
+   return 0.0;
+}
+
+// runs frameCount frames, the mouse sweeping the window and dragging every other 15 frames
+template<typename Draw> static Result Run(const char* widget, int scale, int frameCount, Draw draw)
+{
+   typedef std::chrono::high_resolution_clock Clock;
+   ImGuiIO& io = ImGui::GetIO();
+   Result result = { widget, scale, 0.0, 0.0, 0, 0 };
+   for (int frame = 0; frame < frameCount; frame++)
+   {
+      const float phase = float(frame) / float(frameCount);
+      io.DeltaTime = 1.f / 60.f;
+      io.MousePos = ImVec2(40.f + phase * (io.DisplaySize.x - 80.f), io.DisplaySize.y * (0.5f + 0.3f * sinf(phase * 6.2831853f)));
+      io.MouseDown[0] = ((frame / 15) & 1) != 0;
+      io.MouseWheel = (frame % 20 == 10) ? 1.f : 0.f;
+
+      const Clock::time_point begin = Clock::now();
+      ImGui::NewFrame();
+      ImGui::SetNextWindowPos(ImVec2(0.f, 0.f));
+      ImGui::SetNextWindowSize(io.DisplaySize);
+      ImGui::Begin("benchmark", NULL, ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove);
+      draw();
+      ImGui::End();
+      ImGui::Render();
+      const double ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+      result.meanMs += ms / double(frameCount);
+      result.maxMs = ImMax(result.maxMs, ms);
+      const ImDrawData* drawData = ImGui::GetDrawData();
+      result.vertexCount = drawData->TotalVtxCount;
+      for (int i = 0; i < drawData->CmdListsCount; i++)
+         result.maxListVertexCount = ImMax(result.maxListVertexCount, drawData->CmdLists[i]->VtxBuffer.Size);
+   }
+   return result;
+}
+
+int main(int argc, char** argv)
+{
+   if (argc > 1 && !strcmp(argv[1], "test"))
+   {
+      const int failures = RunTests();
+      printf("%d failed checks\n", failures);
+      return failures ? 1 : 0;
+   }
+   const int frameCount = (argc > 1) ? ImMax(atoi(argv[1]), 1) : 300;
+#ifdef NDEBUG
+   const double budgetScale = (argc > 2) ? atof(argv[2]) : 0.0;
+#else
+   // debug and sanitizer builds are too slow to compare against release budgets
+   const double budgetScale = 0.0;
+#endif
+   const int maxListVertexCount = (sizeof(ImDrawIdx) == 2) ? 65536 : INT_MAX;
+
+   ImGui::CreateContext();
+   ImGuiIO& io = ImGui::GetIO();
+   io.DisplaySize = ImVec2(1280.f, 720.f);
+   io.IniFilename = NULL;
+   unsigned char* pixels;
+   int width, height;
+   io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+   std::vector<Result> results;
+   const int scales[] = { 10, 1000, 100000 };
+   for (int scale : scales)
+   {
+      CurveBench curve(scale);
+      results.push_back(Run("ImCurveEdit", scale, frameCount, [&]() {
+         ImCurveEdit::Edit(curve, ImVec2(1200.f, 600.f), 1);
+      }));
+
+      SequenceBench sequence(scale);
+      int currentFrame = 100;
+      int firstFrame = 0;
+      bool expanded = true;
+      int selectedEntry = -1;
+      results.push_back(Run("ImSequencer", scale, frameCount, [&]() {
+         ImSequencer::Sequencer(&sequence, &currentFrame, &expanded, &selectedEntry, &firstFrame, ImSequencer::SEQUENCER_EDIT_ALL);
+      }));
+
+      ImGradient::GradientStops gradient;
+      std::vector<ImVec4> stops(scale);
+      for (int i = 0; i < scale; i++)
+      {
+         const float t = float(i) / float(ImMax(scale - 1, 1));
+         stops[i] = ImVec4(t, 1.f - t, fmodf(t * 7.f, 1.f), t);
+      }
+      gradient.SetPoints(stops.data(), stops.size());
+      int selection = -1;
+      results.push_back(Run("ImGradient", scale, frameCount, [&]() {
+         ImGradient::Edit(gradient, ImVec2(1200.f, 40.f), selection, 1);
+      }));
+   }
+
+   // gizmos scale with the number of manipulated objects
+   const float view[16] = { 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, -8.f, 1.f };
+   const float projection[16] = { 1.3f, 0.f, 0.f, 0.f, 0.f, 2.3f, 0.f, 0.f, 0.f, 0.f, -1.f, -1.f, 0.f, 0.f, -0.2f, 0.f };
+   const int gizmoScales[] = { 1, 10, 100 };
+   const ImGuizmo::OPERATION operations[] = { ImGuizmo::TRANSLATE, ImGuizmo::ROTATE, ImGuizmo::SCALE };
+   for (int scale : gizmoScales)
+   {
+      std::vector<float> matrices(scale * 16);
+      for (int i = 0; i < scale; i++)
+      {
+         float* matrix = &matrices[i * 16];
+         for (int j = 0; j < 16; j++)
+            matrix[j] = (j % 5) ? 0.f : 1.f;
+         matrix[12] = float(i % 10) - 4.5f;
+         matrix[13] = float(i / 10 % 10) - 4.5f;
+      }
+      results.push_back(Run("ImGuizmo", scale, frameCount, [&]() {
+         ImGuizmo::BeginFrame();
+         ImGuizmo::SetRect(0.f, 0.f, io.DisplaySize.x, io.DisplaySize.y);
+         for (int i = 0; i < scale; i++)
+            ImGuizmo::Manipulate(view, projection, operations[i % 3], ImGuizmo::LOCAL, &matrices[i * 16]);
+      }));
+   }
+
+   ImSequencer::ClearState();
+   ImCurveEdit::ClearState();
+   ImGradient::ClearState();
+   ImGuizmo::ClearRetained();
+   ImGui::DestroyContext();
+
+   bool failed = false;
+   printf("%-12s %8s %10s %10s %10s %10s\n", "widget", "scale", "mean ms", "max ms", "budget ms", "vertices");
+   for (const Result& result : results)
+   {
+      const double budgetMs = GetBudget(result) * budgetScale;
+      const bool overBudget = budgetMs > 0.0 && result.meanMs > budgetMs;
+      const bool tooManyVertices = result.maxListVertexCount > maxListVertexCount;
+      printf("%-12s %8d %10.3f %10.3f %10.3f %10d%s%s\n", result.widget, result.scale, result.meanMs, result.maxMs, budgetMs, result.vertexCount,
+         overBudget ? "  over budget" : "", tooManyVertices ? "  too many vertices in a draw list" : "");
+      failed |= overBudget || tooManyVertices;
+   }
+   return failed ? 1 : 0;
+}
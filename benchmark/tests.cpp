@@ -0,0 +1,381 @@
+// Unit tests of the algorithms behind the widgets. The library is built here as a single translation unit
+// so the tests can reach its internal helpers (clip search, frame labels).
+#include "ImGuizmoUnity.cpp"
+
+#include "ImCurveSample.h"
+#include "ImGradientStops.h"
+#include "ImSequencerPlayback.h"
+#include "ImSequencerWaveform.h"
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static int failureCount = 0;
+
+#define TEST_CHECK(condition) \
+   do { if (!(condition)) { failureCount++; printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); } } while (0)
+
+// deterministic pseudo random values in [0, 1)
+static float Random(unsigned int& seed)
+{
+   seed = seed * 1664525u + 1013904223u;
+   return float(seed >> 8) / float(1 << 24);
+}
+
+struct CurveTest : public ImCurveEdit::Delegate
+{
+   CurveTest()
+   {
+      unsigned int seed = 7;
+      float x = 0.f;
+      for (int i = 0; i < 16; i++)
+      {
+         x += 0.25f + Random(seed);
+         mPts.push_back(ImVec2(x, Random(seed) * 2.f - 1.f));
+         mTangents.push_back(ImVec2(-0.2f * Random(seed) - 0.05f, Random(seed) - 0.5f));
+         mTangents.push_back(ImVec2(0.2f * Random(seed) + 0.05f, Random(seed) - 0.5f));
+      }
+   }
+
+   size_t GetCurveCount() { return 4; }
+   ImVec2& GetMin() { return mMin; }
+   ImVec2& GetMax() { return mMax; }
+   size_t GetPointCount(size_t) { return mPts.size(); }
+   uint32_t GetCurveColor(size_t) { return 0xFFFFFFFF; }
+   ImVec2* GetPoints(size_t) { return mPts.data(); }
+   // one curve per type, sharing the points
+   virtual ImCurveEdit::CurveType GetCurveType(size_t curveIndex) const
+   {
+      static const ImCurveEdit::CurveType types[] = { ImCurveEdit::CurveDiscrete, ImCurveEdit::CurveLinear, ImCurveEdit::CurveSmooth, ImCurveEdit::CurveBezier };
+      return types[curveIndex];
+   }
+   virtual ImVec2* GetTangents(size_t) { return mTangents.data(); }
+   virtual int EditPoint(size_t, int pointIndex, ImVec2) { return pointIndex; }
+   virtual void AddPoint(size_t, ImVec2) {}
+
+   std::vector<ImVec2> mPts;
+   std::vector<ImVec2> mTangents;
+   ImVec2 mMin = ImVec2(0.f, -1.f);
+   ImVec2 mMax = ImVec2(20.f, 1.f);
+};
+
+static void TestCurveSample()
+{
+   CurveTest curve;
+   std::vector<float> x, y;
+   for (float v = -1.f; v < 22.f; v += 0.0137f)
+      x.push_back(v);
+   y.resize(x.size());
+   for (size_t c = 0; c < curve.GetCurveCount(); c++)
+   {
+      ImCurveEdit::Sample(curve, c, x.data(), y.data(), x.size());
+      float maxError = 0.f;
+      for (size_t i = 0; i < x.size(); i++)
+         maxError = ImMax(maxError, fabsf(y[i] - ImCurveEdit::Evaluate(curve, c, x[i])));
+      TEST_CHECK(maxError < 1e-4f);
+
+      // more entries than one bake chunk
+      float lut[300];
+      ImCurveEdit::Bake(curve, c, 0.f, 20.f, lut, 300);
+      float maxLutError = 0.f;
+      for (int i = 0; i < 300; i++)
+         maxLutError = ImMax(maxLutError, fabsf(lut[i] - ImCurveEdit::Evaluate(curve, c, 20.f * float(i) / 299.f)));
+      TEST_CHECK(maxLutError < 1e-3f);
+      TEST_CHECK(fabsf(lut[299] - ImCurveEdit::Evaluate(curve, c, 20.f)) < 1e-4f);
+   }
+}
+
+// items holding several sorted clips
+struct ClipTest : public ImSequencer::SequenceInterface
+{
+   ClipTest()
+   {
+      unsigned int seed = 3;
+      for (int item = 0; item < 8; item++)
+      {
+         std::vector<int> clips;
+         int frame = int(Random(seed) * 20.f);
+         const int clipCount = item * 3;
+         for (int i = 0; i < clipCount; i++)
+         {
+            const int start = frame + int(Random(seed) * 10.f);
+            const int end = start + int(Random(seed) * 8.f);
+            clips.push_back(start);
+            clips.push_back(end);
+            frame = end + 1;
+         }
+         mClips.push_back(clips);
+      }
+   }
+
+   virtual int GetFrameMin() const { return 0; }
+   virtual int GetFrameMax() const { return 500; }
+   virtual int GetItemCount() const { return int(mClips.size()); }
+   virtual void Get(int index, int** start, int** end, int*, unsigned int*) { GetClip(index, 0, start, end, NULL); }
+   virtual int GetClipCount(int index) { return int(mClips[index].size() / 2); }
+   virtual void GetClip(int index, int clipIndex, int** start, int** end, unsigned int* color)
+   {
+      if (start)
+         *start = &mClips[index][clipIndex * 2];
+      if (end)
+         *end = &mClips[index][clipIndex * 2 + 1];
+      if (color)
+         *color = 0xFFFFFFFF;
+   }
+
+   std::vector<std::vector<int> > mClips;
+};
+
+static void TestFindClips()
+{
+   ClipTest sequence;
+   for (int item = 0; item < sequence.GetItemCount(); item++)
+   {
+      const std::vector<int>& clips = sequence.mClips[item];
+      for (int firstFrame = -5; firstFrame < 300; firstFrame += 3)
+      {
+         for (int lastFrame = firstFrame; lastFrame < firstFrame + 40; lastFrame += 7)
+         {
+            int firstClip, lastClip;
+            ImSequencer::FindClips(&sequence, NULL, item, firstFrame, lastFrame, firstClip, lastClip);
+            int expectedFirst = -1, expectedLast = -2;
+            for (int clip = 0; clip < int(clips.size() / 2); clip++)
+            {
+               if (clips[clip * 2 + 1] >= firstFrame && clips[clip * 2] <= lastFrame)
+               {
+                  if (expectedFirst < 0)
+                     expectedFirst = clip;
+                  expectedLast = clip;
+               }
+            }
+            if (expectedFirst < 0)
+               TEST_CHECK(lastClip < firstClip);
+            else
+               TEST_CHECK(firstClip == expectedFirst && lastClip == expectedLast);
+         }
+      }
+   }
+
+   // spans describe one clip per item
+   int start = 10, end = 20;
+   unsigned int color = 0;
+   ImSequencer::ItemSpans spans;
+   spans.start = &start;
+   spans.end = &end;
+   spans.color = &color;
+   int firstClip, lastClip;
+   ImSequencer::FindClips(&sequence, &spans, 0, 15, 30, firstClip, lastClip);
+   TEST_CHECK(firstClip == 0 && lastClip == 0);
+   ImSequencer::FindClips(&sequence, &spans, 0, 21, 30, firstClip, lastClip);
+   TEST_CHECK(lastClip < firstClip);
+}
+
+static void TestWaveformMipmap()
+{
+   unsigned int seed = 11;
+   std::vector<float> samples(2 * 1531);
+   for (size_t i = 0; i < samples.size(); i++)
+      samples[i] = Random(seed) * 2.f - 1.f;
+
+   // every other sample, as an interleaved stereo stream
+   ImSequencer::WaveformMipmap mipmap;
+   mipmap.Build(samples.data(), samples.size() / 2, 2);
+   TEST_CHECK(mipmap.GetSampleCount() == samples.size() / 2);
+   for (int test = 0; test < 2000; test++)
+   {
+      size_t first = size_t(Random(seed) * float(mipmap.GetSampleCount()));
+      size_t last = first + 1 + size_t(Random(seed) * float(mipmap.GetSampleCount() - first));
+      float minValue, maxValue;
+      mipmap.GetRange(first, last, minValue, maxValue);
+      float expectedMin = FLT_MAX, expectedMax = -FLT_MAX;
+      for (size_t i = first; i < last; i++)
+      {
+         expectedMin = ImMin(expectedMin, samples[i * 2]);
+         expectedMax = ImMax(expectedMax, samples[i * 2]);
+      }
+      TEST_CHECK(minValue == expectedMin && maxValue == expectedMax);
+   }
+
+   float minValue, maxValue;
+   mipmap.GetRange(10, 10, minValue, maxValue);
+   TEST_CHECK(minValue > maxValue);
+}
+
+// playback clock advanced by the test, in nanoseconds
+static int64_t testTime = 0;
+
+static int64_t TestClock()
+{
+   return testTime;
+}
+
+static void AdvanceClock(double seconds)
+{
+   testTime += int64_t(seconds * 1e9);
+}
+
+static void TestPlayback()
+{
+   ImSequencer::Playback playback;
+   playback.SetClock(TestClock);
+   playback.SetFrameRate(100.0);
+   playback.SetRange(0, 100);
+   int currentFrame = 0;
+   playback.Update(&currentFrame);
+   playback.Play();
+   AdvanceClock(0.5);
+   TEST_CHECK(playback.Update(&currentFrame));
+   TEST_CHECK(currentFrame == 50 && playback.IsPlaying());
+   // stops on the last frame
+   AdvanceClock(1.0);
+   playback.Update(&currentFrame);
+   TEST_CHECK(currentFrame == 100 && !playback.IsPlaying());
+
+   playback.SetRate(-1.f);
+   playback.Play();
+   AdvanceClock(2.0);
+   playback.Update(&currentFrame);
+   TEST_CHECK(currentFrame == 0 && !playback.IsPlaying());
+
+   // loops stay within [start, end]
+   playback.SetRate(1.f);
+   playback.SetLoop(10, 20);
+   playback.Play();
+   for (int i = 0; i < 20; i++)
+   {
+      AdvanceClock(0.037);
+      playback.Update(&currentFrame);
+      TEST_CHECK(currentFrame >= 10 && currentFrame <= 20 && playback.IsPlaying());
+   }
+   playback.Pause();
+
+   // scrubs are clamped like the playhead
+   playback.Scrub(50);
+   playback.Update(&currentFrame);
+   TEST_CHECK(currentFrame == 20);
+   playback.SetLoop(0, -1);
+   playback.Scrub(-30);
+   playback.Update(&currentFrame);
+   TEST_CHECK(currentFrame == 0);
+   currentFrame = 42;
+   TEST_CHECK(!playback.Update(&currentFrame));
+   TEST_CHECK(currentFrame == 42 && int(playback.GetPosition()) == 42);
+
+   // rate changes keep the time played since the last update
+   ImSequencer::Playback rated;
+   rated.SetClock(TestClock);
+   rated.SetFrameRate(100.0);
+   rated.SetRange(0, 1000000);
+   currentFrame = 0;
+   rated.Update(&currentFrame);
+   rated.Play();
+   AdvanceClock(0.25);
+   rated.SetRate(2.f);
+   AdvanceClock(0.25);
+   rated.SetFrameRate(200.0);
+   AdvanceClock(0.25);
+   rated.Update(&currentFrame);
+   TEST_CHECK(currentFrame == 25 + 50 + 100);
+
+   // pausing doesn't move the playhead back, readers see the paused frame
+   AdvanceClock(0.1);
+   rated.Pause();
+   AdvanceClock(0.1);
+   rated.Update(&currentFrame);
+   TEST_CHECK(currentFrame == 175 + 40 && currentFrame == int(floor(rated.GetPosition())));
+   const ImSequencer::PlayheadState playhead = rated.ReadPlayhead();
+   TEST_CHECK(!playhead.playing && int(playhead.frame) == currentFrame && playhead.time == testTime - int64_t(0.1 * 1e9));
+}
+
+static bool IsSorted(ImGradient::GradientStops& gradient)
+{
+   for (size_t i = 1; i < gradient.GetPointCount(); i++)
+   {
+      if (gradient.GetPoints()[i - 1].w > gradient.GetPoints()[i].w)
+         return false;
+   }
+   return true;
+}
+
+static void TestGradientStops()
+{
+   ImGradient::GradientStops gradient;
+   const unsigned int version = gradient.GetVersion();
+   unsigned int seed = 5;
+   for (int i = 0; i < 32; i++)
+      gradient.AddPoint(ImVec4(Random(seed), Random(seed), Random(seed), Random(seed)));
+   TEST_CHECK(gradient.GetPointCount() == 32 && IsSorted(gradient));
+   TEST_CHECK(gradient.GetVersion() != version);
+
+   // moved stops keep the order and are found at the returned index
+   for (int i = 0; i < 200; i++)
+   {
+      const int index = int(Random(seed) * 32.f);
+      const ImVec4 value(Random(seed), Random(seed), Random(seed), Random(seed));
+      const int newIndex = gradient.EditPoint(index, value);
+      TEST_CHECK(IsSorted(gradient));
+      TEST_CHECK(newIndex >= 0 && newIndex < 32);
+      const ImVec4& moved = gradient.GetPoints()[newIndex];
+      TEST_CHECK(moved.x == value.x && moved.y == value.y && moved.z == value.z && moved.w == value.w);
+   }
+
+   for (int i = 0; i < 32; i++)
+   {
+      const float t = Random(seed);
+      const int interval = gradient.FindInterval(t);
+      TEST_CHECK(interval == 0 || gradient.GetPoints()[interval - 1].w <= t);
+      TEST_CHECK(interval == 32 || gradient.GetPoints()[interval].w > t);
+   }
+
+   // a stop color is returned at its position
+   const ImVec4 stop = gradient.GetPoints()[12];
+   const ImVec4 color = gradient.GetPoint(stop.w);
+   TEST_CHECK(fabsf(color.x - stop.x) < 1e-5f && fabsf(color.y - stop.y) < 1e-5f && fabsf(color.z - stop.z) < 1e-5f);
+
+   gradient.RemovePoint(0);
+   TEST_CHECK(gradient.GetPointCount() == 31 && IsSorted(gradient));
+}
+
+static void TestFrameLabels()
+{
+   char text[32];
+   ImSequencer::FormatFrame(text, 0, 0);
+   TEST_CHECK(!strcmp(text, "0"));
+   ImSequencer::FormatFrame(text, -1234, 0);
+   TEST_CHECK(!strcmp(text, "-1234"));
+   ImSequencer::FormatFrame(text, INT_MIN, 0);
+   TEST_CHECK(!strcmp(text, "-2147483648"));
+   ImSequencer::FormatFrame(text, ((1 * 60 + 2) * 60 + 3) * 24 + 5, 24);
+   TEST_CHECK(!strcmp(text, "01:02:03:05"));
+   ImSequencer::FormatFrame(text, -24, 24);
+   TEST_CHECK(!strcmp(text, "-00:00:01:00"));
+   ImSequencer::FormatFrame(text, 100 * 3600 * 30, 30);
+   TEST_CHECK(!strcmp(text, "100:00:00:00"));
+
+   ImSequencer::LabelCache labels;
+   const char* label = labels.Get(25, 0);
+   TEST_CHECK(!strcmp(label, "25"));
+   TEST_CHECK(labels.Get(25, 0) == label);
+   TEST_CHECK(!strcmp(labels.Get(25, 24), "00:00:01:01"));
+   // past the cache bound, labels are still right
+   for (int frame = 0; frame < 20000; frame++)
+   {
+      ImSequencer::FormatFrame(text, frame, 24);
+      TEST_CHECK(!strcmp(labels.Get(frame, 24), text));
+   }
+}
+
+// returns the number of failed checks
+int RunTests()
+{
+   TestCurveSample();
+   TestFindClips();
+   TestWaveformMipmap();
+   TestPlayback();
+   TestGradientStops();
+   TestFrameLabels();
+   return failureCount;
+}
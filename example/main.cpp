@@ -376,9 +376,12 @@ struct MySequence : public ImSequencer::SequenceInterface
 
   virtual size_t GetCustomHeight(int index) { return myItems[index].mExpanded ? 300 : 0; }
 
+  virtual unsigned int GetLayoutVersion() const { return mLayoutVersion; }
+
    // my datas
-  MySequence() : mFrameMin(0), mFrameMax(0) {}
+  MySequence() : mFrameMin(0), mFrameMax(0), mLayoutVersion(1) {}
   int mFrameMin, mFrameMax;
+  unsigned int mLayoutVersion;
   struct MySequenceItem
   {
     int mType;
@@ -390,6 +393,7 @@ struct MySequence : public ImSequencer::SequenceInterface
   RampEdit rampEdit;
 
   virtual void DoubleClick(int index) {
+      mLayoutVersion++;
       if (myItems[index].mExpanded) {
          myItems[index].mExpanded = false;
          return;
@@ -402,7 +406,7 @@ struct MySequence : public ImSequencer::SequenceInterface
       myItems[index].mExpanded = !myItems[index].mExpanded;
    }
 
-   virtual void CustomDraw(int index, ImDrawList* draw_list, const ImRect& rc, const ImRect& legendRect, const ImRect& clippingRect, const ImRect& legendClippingRect)
+   virtual void CustomDraw(int index, ImDrawList* draw_list, const ImRect& rc, const ImRect& legendRect, const ImRect& clippingRect, const ImRect& legendClippingRect, const ImSequencer::FrameRange& /*visibleFrames*/)
    {
       static const char *labels[] = { "Translation", "Rotation" , "Scale" };
 
@@ -425,7 +429,7 @@ struct MySequence : public ImSequencer::SequenceInterface
       ImCurveEdit::Edit(rampEdit, rc.Max-rc.Min, 137 + index, &clippingRect);
    }
 
-   virtual void CustomDrawCompact(int index, ImDrawList* draw_list, const ImRect& rc, const ImRect& clippingRect)
+   virtual void CustomDrawCompact(int index, ImDrawList* draw_list, const ImRect& rc, const ImRect& clippingRect, const ImSequencer::FrameRange& visibleFrames)
    {
       rampEdit.mMax = ImVec2(float(mFrameMax), 1.f);
       rampEdit.mMin = ImVec2(float(mFrameMin), 0.f);
@@ -435,7 +439,7 @@ struct MySequence : public ImSequencer::SequenceInterface
       for (int i = 0; i < 3; i++) {
          for (int j = 0; j < rampEdit.mPointCount[i]; j++) {
             float p = rampEdit.mPts[i][j].x;
-            if (p < myItems[index].mFrameStart || p > myItems[index].mFrameEnd) {
+            if (p < myItems[index].mFrameStart || p > myItems[index].mFrameEnd || p < visibleFrames.first || p > visibleFrames.last + 1) {
                continue;
             }
 
@@ -685,6 +689,9 @@ int main(int, char**)
 
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
+    ImSequencer::ClearState();
+    ImCurveEdit::ClearState();
+    ImGuizmo::ClearRetained();
     ImGui::DestroyContext();
 
     glfwDestroyWindow(window);